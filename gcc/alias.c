@@ -90,6 +90,7 @@ static alias_set_entry get_alias_set_entry (int);
 static rtx fixed_scalar_and_varying_struct_p (rtx, rtx, int (*)(rtx));
 static int aliases_everything_p         (rtx);
 static int write_dependence_p           (rtx, rtx, int);
+static struct alias_memo *lookup_alias_memo (rtx, rtx, int);
 
 /* Set up all info needed to perform alias analysis on memory references.  */
 
@@ -168,6 +169,31 @@ static int copying_arguments;
 
 static splay_tree alias_sets;
 
+/* Results of anti_dependence and output_dependence remembered between
+   begin_alias_memo and end_alias_memo.  The table is direct mapped on
+   the addresses of the two MEMs; an entry is valid only if its
+   GENERATION is the current alias_memo_generation.  */
+
+#define ALIAS_MEMO_SIZE 1024
+
+struct alias_memo
+{
+  rtx mem, x;
+  int writep;
+  int result;
+  int generation;
+};
+
+static struct alias_memo *alias_memo;
+
+/* Nonzero while dependence results are being remembered.  */
+
+static int alias_memo_generation;
+
+/* The last generation handed out.  */
+
+static int alias_memo_last;
+
 /* Returns -1, 0, 1 according to whether SET1 is less than, equal to,
    or greater than SET2.  */
 
@@ -538,6 +564,10 @@ record_base_value (regno, val, invariant)
   if ((unsigned) regno >= reg_base_value_size)
     return;
 
+  /* Remembered dependences may have relied on the old base value.  */
+  if (alias_memo_generation)
+    alias_memo_generation = ++alias_memo_last;
+
   /* If INVARIANT is true then this value also describes an invariant
      relationship which can be used to deduce that two registers with
      unknown values are different.  */
@@ -1255,6 +1285,20 @@ write_dependence_p (mem, x, writep)
 	  && !(fixed_scalar == x && !aliases_everything_p (mem)));
 }
 
+/* Return the slot of the memo table for the question asked by
+   write_dependence_p (MEM, X, WRITEP).  */
+
+static struct alias_memo *
+lookup_alias_memo (mem, x, writep)
+     rtx mem, x;
+     int writep;
+{
+  unsigned long hash;
+
+  hash = ((unsigned long) mem >> 3) * 31 + ((unsigned long) x >> 3) + writep;
+  return &alias_memo[hash % ALIAS_MEMO_SIZE];
+}
+
 /* Anti dependence: X is written after read in MEM takes place.  */
 
 int
@@ -1262,7 +1306,20 @@ anti_dependence (mem, x)
      rtx mem;
      rtx x;
 {
-  return write_dependence_p (mem, x, /*writep=*/0);
+  struct alias_memo *p;
+
+  if (! alias_memo_generation)
+    return write_dependence_p (mem, x, /*writep=*/0);
+
+  p = lookup_alias_memo (mem, x, 0);
+  if (p->generation != alias_memo_generation
+      || p->mem != mem || p->x != x || p->writep != 0)
+    {
+      p->mem = mem, p->x = x, p->writep = 0;
+      p->result = write_dependence_p (mem, x, /*writep=*/0);
+      p->generation = alias_memo_generation;
+    }
+  return p->result;
 }
 
 /* Output dependence: X is written after store in MEM takes place.  */
@@ -1272,7 +1329,43 @@ output_dependence (mem, x)
      register rtx mem;
      register rtx x;
 {
-  return write_dependence_p (mem, x, /*writep=*/1);
+  struct alias_memo *p;
+
+  if (! alias_memo_generation)
+    return write_dependence_p (mem, x, /*writep=*/1);
+
+  p = lookup_alias_memo (mem, x, 1);
+  if (p->generation != alias_memo_generation
+      || p->mem != mem || p->x != x || p->writep != 1)
+    {
+      p->mem = mem, p->x = x, p->writep = 1;
+      p->result = write_dependence_p (mem, x, /*writep=*/1);
+      p->generation = alias_memo_generation;
+    }
+  return p->result;
+}
+
+/* Start remembering the results of anti_dependence and
+   output_dependence.  The caller must not change any MEM it asks about,
+   nor anything the answers depend on, until it calls end_alias_memo.
+   This pays off for passes that ask the same questions over and over,
+   such as the iterations of life analysis.  */
+
+void
+begin_alias_memo ()
+{
+  if (alias_memo == 0)
+    alias_memo = (struct alias_memo *) xcalloc (ALIAS_MEMO_SIZE,
+						sizeof (struct alias_memo));
+  alias_memo_generation = ++alias_memo_last;
+}
+
+/* Forget the results remembered since begin_alias_memo.  */
+
+void
+end_alias_memo ()
+{
+  alias_memo_generation = 0;
 }
 
 
@@ -1495,6 +1588,7 @@ init_alias_analysis ()
 void
 end_alias_analysis ()
 {
+  end_alias_memo ();
   reg_known_value = 0;
   reg_base_value = 0;
   reg_base_value_size = 0;
@@ -5220,6 +5220,9 @@ finish_init ()
 {
   struct initializer_stack *p = initializer_stack;
 
+  /* Finish any run of data that output_constant has collected.  */
+  output_data_run ();
+
   /* Output subconstants (string constants, usually)
      that were referenced within this initializer and saved up.
      Must do this if and only if we called defer_addressed_constants.  */
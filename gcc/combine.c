@@ -90,6 +90,13 @@ Boston, MA 02111-1307, USA.  */
 #include "recog.h"
 #include "real.h"
 #include "toplev.h"
+#include "obstack.h"
+
+#define obstack_chunk_alloc xmalloc
+#define obstack_chunk_free free
+
+extern struct obstack *rtl_obstack;
+extern int _obstack_allocated_p (struct obstack *h, void *obj);
 
 /* It is not safe to use ordinary gen_lowpart in combine.
    Use gen_lowpart_for_combine instead.  See comments there.  */
@@ -194,6 +201,16 @@ static rtx added_links_insn;
 
 /* Basic block number of the block in which we are performing combines.  */
 static int this_basic_block;
+
+/* The insns that were volatile when combine started, in insn order, and
+   how many of them there are.  volatile_insn_between_p searches these
+   instead of walking every insn between the two it is given.  Once a
+   combination produces a volatile insn, which may not be listed,
+   volatile_insns_valid is cleared and the walk is used again.  */
+
+static rtx *volatile_insns;
+static int n_volatile_insns;
+static int volatile_insns_valid;
 
 /* The next group of arrays allows the recording of the last value assigned
    to (hard or pseudo) register n.  We use this information to see if a
@@ -315,8 +332,11 @@ struct undo
 /* Record a bunch of changes to be undone, up to MAX_UNDO of them.
    num_undo says how many are currently recorded.
 
-   storage is nonzero if we must undo the allocation of new storage.
-   The value of storage is what to pass to obfree.
+   storage is the start of the rtl built in combine_obstack for the
+   combination being tried; it is what to pass to obstack_free.
+
+   real_obstack is the obstack that rtl_obstack pointed to before we
+   switched it to combine_obstack.
 
    other_insn is nonzero if we have modified some other insn in the process
    of working on subst_insn.  It must be verified too.
@@ -329,6 +349,7 @@ struct undo
 struct undobuf
 {
   char *storage;
+  struct obstack *real_obstack;
   struct undo *undos;
   struct undo *frees;
   struct undo *previous_undos;
@@ -337,6 +358,14 @@ struct undobuf
 
 static struct undobuf undobuf;
 
+/* All rtl made while a combination is being tried is allocated in this
+   obstack.  If the combination fails, it is simply rewound; if it
+   succeeds, the rtl that ended up in the insns is copied to the real
+   rtl obstack first.  That way only accepted combinations use up
+   memory for the rest of the function.  */
+
+static struct obstack combine_obstack;
+
 /* Substitute NEWVAL, an rtx expression, into INTO, a place in some
    insn.  The substitution can be undone by undo_all.  If INTO is already
    set to NEWVAL, do not record this change.  Because computing NEWVAL might
@@ -392,11 +421,14 @@ static int n_occurrences;
 static void init_reg_last_arrays	(void);
 static void setup_incoming_promotions   (void);
 static void set_nonzero_bits_and_sign_copies  (rtx, rtx);
+static int volatile_insn_between_p (rtx, rtx, rtx);
 static int can_combine_p	(rtx, rtx, rtx, rtx, rtx *, rtx *);
 static int sets_function_arg_p	(rtx);
 static int combinable_i3pat	(rtx, rtx *, rtx, rtx, int, rtx *);
 static rtx try_combine		(rtx, rtx, rtx);
 static void undo_all		(void);
+static rtx keep_combine_rtx	(rtx);
+static void keep_combine_storage (void);
 static rtx *find_split_point	(rtx *, rtx);
 static rtx subst		(rtx, rtx, rtx, int, int);
 static rtx simplify_rtx		(rtx, enum machine_mode, int, int);
@@ -472,6 +504,7 @@ combine_instructions (f, nregs)
   combine_extras = 0;
   combine_successes = 0;
   undobuf.undos = undobuf.previous_undos = 0;
+  gcc_obstack_init (&combine_obstack);
 
   combine_max_regno = nregs;
 
@@ -508,6 +541,10 @@ combine_instructions (f, nregs)
   uid_cuid = (int *) alloca ((i + 1) * sizeof (int));
   max_uid_cuid = i;
 
+  volatile_insns = (rtx *) alloca ((i + 1) * sizeof (rtx));
+  n_volatile_insns = 0;
+  volatile_insns_valid = 1;
+
   nonzero_bits_mode = mode_for_size (HOST_BITS_PER_WIDE_INT, MODE_INT, 0);
 
   /* Don't use reg_nonzero_bits when computing it.  This can cause problems
@@ -542,6 +579,9 @@ combine_instructions (f, nregs)
 
       if (GET_RTX_CLASS (GET_CODE (insn)) == 'i')
 	{
+	  if (volatile_insn_p (PATTERN (insn)))
+	    volatile_insns[n_volatile_insns++] = insn;
+
 	  note_stores (PATTERN (insn), set_nonzero_bits_and_sign_copies);
 	  record_dead_and_set_regs (insn);
 
@@ -673,6 +713,8 @@ combine_instructions (f, nregs)
   total_extras += combine_extras;
   total_successes += combine_successes;
 
+  obstack_free (&combine_obstack, NULL);
+
   nonzero_sign_valid = 0;
 
   /* Make recognizer allow volatile MEMs again.  */
@@ -805,6 +847,51 @@ set_nonzero_bits_and_sign_copies (x, set)
     }
 }
 
+/* Return nonzero if any insn after FROM and before TO, other than SKIP,
+   is volatile.  */
+
+static int
+volatile_insn_between_p (from, to, skip)
+     rtx from, to, skip;
+{
+  rtx p;
+  int lo, hi, mid;
+  int to_cuid;
+
+  if (! volatile_insns_valid)
+    {
+      for (p = NEXT_INSN (from); p != to; p = NEXT_INSN (p))
+	if (GET_RTX_CLASS (GET_CODE (p)) == 'i'
+	    && p != skip && volatile_insn_p (PATTERN (p)))
+	  return 1;
+      return 0;
+    }
+
+  /* Find the first listed insn after FROM.  Listed insns that were
+     deleted or combined since are checked again below.  */
+  lo = 0, hi = n_volatile_insns;
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (INSN_CUID (volatile_insns[mid]) <= INSN_CUID (from))
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  to_cuid = INSN_CUID (to);
+  for (; lo < n_volatile_insns && INSN_CUID (volatile_insns[lo]) < to_cuid;
+       lo++)
+    {
+      p = volatile_insns[lo];
+      if (GET_RTX_CLASS (GET_CODE (p)) == 'i'
+	  && p != skip && volatile_insn_p (PATTERN (p)))
+	return 1;
+    }
+
+  return 0;
+}
+
 /* See if INSN can be combined into I3.  PRED and SUCC are optionally
    insns that were previously combined into I3 or that will be combined
    into the merger of INSN and I3.
@@ -1066,10 +1153,8 @@ can_combine_p (insn, i3, pred, succ, pdest, psrc)
   /* If there are any volatile insns between INSN and I3, reject, because
      they might affect machine state.  */
 
-  for (p = NEXT_INSN (insn); p != i3; p = NEXT_INSN (p))
-    if (GET_RTX_CLASS (GET_CODE (p)) == 'i'
-	&& p != succ && volatile_insn_p (PATTERN (p)))
-      return 0;
+  if (volatile_insn_between_p (insn, i3, succ))
+    return 0;
 
   /* If INSN or I2 contains an autoincrement or autodecrement,
      make sure that register is not used between there and I3,
@@ -1351,6 +1436,8 @@ try_combine (i3, i2, i1)
   int i3_subst_into_i2 = 0;
   /* Notes that I1, I2 or I3 is a MULT operation.  */
   int have_mult = 0;
+  /* New pattern and notes for undobuf.other_insn, if any.  */
+  rtx other_pat, new_other_notes;
 
   int maxreg;
   rtx temp;
@@ -1379,9 +1466,11 @@ try_combine (i3, i2, i1)
   undobuf.undos = undobuf.previous_undos = 0;
   undobuf.other_insn = 0;
 
-  /* Save the current high-water-mark so we can free storage if we didn't
-     accept this combination.  */
-  undobuf.storage = (char *) oballoc (0);
+  /* Build all new rtl in combine_obstack, saving its high-water-mark so
+     we can free the storage if we don't accept this combination.  */
+  undobuf.storage = (char *) obstack_alloc (&combine_obstack, 0);
+  undobuf.real_obstack = rtl_obstack;
+  rtl_obstack = &combine_obstack;
 
   /* Reset the hard register usage information.  */
   CLEAR_HARD_REG_SET (newpat_used_regs);
@@ -1712,10 +1801,15 @@ try_combine (i3, i2, i1)
 
 	  if (i2_code_number >= 0 && insn_code_number >= 0)
 	    {
+	      newi2pat = keep_combine_rtx (newi2pat);
+	      newpat = keep_combine_rtx (newpat);
+	      keep_combine_storage ();
 	      PATTERN (i2) = newi2pat;
 	      PATTERN (i3) = newpat;
 	      INSN_CODE (i2) = i2_code_number;
 	      INSN_CODE (i3) = insn_code_number;
+	      if (volatile_insn_p (newi2pat) || volatile_insn_p (newpat))
+		volatile_insns_valid = 0;
 	      return i2;
 	    }
 	  else
@@ -2295,9 +2389,7 @@ try_combine (i3, i2, i1)
   /* If we had to change another insn, make sure it is valid also.  */
   if (undobuf.other_insn)
     {
-      rtx other_pat = PATTERN (undobuf.other_insn);
-      rtx new_other_notes;
-      rtx note, next;
+      other_pat = PATTERN (undobuf.other_insn);
 
       CLEAR_HARD_REG_SET (newpat_used_regs);
 
@@ -2309,6 +2401,27 @@ try_combine (i3, i2, i1)
 	  undo_all ();
 	  return 0;
 	}
+    }
+
+  /* The combination will be made, so move the rtl it uses out of
+     combine_obstack before anything is changed for good.  */
+  newpat = keep_combine_rtx (newpat);
+  new_i3_notes = keep_combine_rtx (new_i3_notes);
+  if (newi2pat)
+    {
+      newi2pat = keep_combine_rtx (newi2pat);
+      new_i2_notes = keep_combine_rtx (new_i2_notes);
+    }
+  if (undobuf.other_insn)
+    {
+      other_pat = keep_combine_rtx (other_pat);
+      new_other_notes = keep_combine_rtx (new_other_notes);
+    }
+  keep_combine_storage ();
+
+  if (undobuf.other_insn)
+    {
+      rtx note, next;
 
       PATTERN (undobuf.other_insn) = other_pat;
 
@@ -2387,6 +2500,11 @@ try_combine (i3, i2, i1)
     if (undobuf.other_insn)
       INSN_CODE (undobuf.other_insn) = other_code_number;
 
+    if (volatile_insn_p (newpat)
+	|| (newi2pat && volatile_insn_p (newi2pat))
+	|| (undobuf.other_insn && volatile_insn_p (other_pat)))
+      volatile_insns_valid = 0;
+
     /* We had one special case above where I2 had more than one set and
        we replaced a destination of one of those sets with the destination
        of I3.  In that case, we have to update LOG_LINKS of insns later
@@ -2662,13 +2780,111 @@ undo_all ()
       undobuf.frees = undo;
     }
 
-  obfree (undobuf.storage);
+  rtl_obstack = undobuf.real_obstack;
+  obstack_free (&combine_obstack, undobuf.storage);
   undobuf.undos = undobuf.previous_undos = 0;
 
   /* Clear this here, so that subsequent get_last_value calls are not
      affected.  */
   subst_prev_insn = NULL_RTX;
 }
+
+/* Return X, or a copy of it in the real rtl obstack if X was built in
+   combine_obstack.  Anything X refers to that is in combine_obstack is
+   copied too.  Each object copied is overwritten with a pointer to its
+   copy, so shared structure stays shared.  */
+
+static rtx
+keep_combine_rtx (x)
+     rtx x;
+{
+  register rtx copy;
+  register rtvec vec;
+  register char *fmt;
+  register int i, j, length;
+
+  if (x == 0 || ! _obstack_allocated_p (&combine_obstack, x))
+    return x;
+
+  /* An UNKNOWN here is an rtx we have already copied.  */
+  if (GET_CODE (x) == UNKNOWN)
+    return XEXP (x, 0);
+
+  length = GET_RTX_LENGTH (GET_CODE (x));
+  copy = (rtx) obstack_alloc (undobuf.real_obstack,
+			      sizeof (struct rtx_def)
+			      + (length - 1) * sizeof (rtunion));
+  copy_memory ((char *) x, (char *) copy,
+	       sizeof (struct rtx_def) + (length - 1) * sizeof (rtunion));
+
+  /* An rtx with no operands has no room for the forwarding pointer;
+     none of those need to stay shared.  */
+  if (length > 0)
+    {
+      PUT_CODE (x, UNKNOWN);
+      XEXP (x, 0) = copy;
+    }
+
+  fmt = GET_RTX_FORMAT (GET_CODE (copy));
+  for (i = 0; i < length; i++)
+    switch (fmt[i])
+      {
+      case 'e':
+	XEXP (copy, i) = keep_combine_rtx (XEXP (copy, i));
+	break;
+
+      case 'E':
+      case 'V':
+	vec = XVEC (copy, i);
+	if (vec == 0 || ! _obstack_allocated_p (&combine_obstack, vec))
+	  break;
+
+	/* A negative length marks a vector we have already copied.  */
+	if (GET_NUM_ELEM (vec) < 0)
+	  {
+	    XVEC (copy, i) = vec->elem[0].rtvec;
+	    break;
+	  }
+
+	XVEC (copy, i)
+	  = (rtvec) obstack_alloc (undobuf.real_obstack,
+				   sizeof (struct rtvec_def)
+				   + (GET_NUM_ELEM (vec) - 1) * sizeof (rtunion));
+	copy_memory ((char *) vec, (char *) XVEC (copy, i),
+		     sizeof (struct rtvec_def)
+		     + (GET_NUM_ELEM (vec) - 1) * sizeof (rtunion));
+	if (GET_NUM_ELEM (vec) > 0)
+	  {
+	    PUT_NUM_ELEM (vec, -1);
+	    vec->elem[0].rtvec = XVEC (copy, i);
+	  }
+
+	for (j = 0; j < XVECLEN (copy, i); j++)
+	  XVECEXP (copy, i, j) = keep_combine_rtx (XVECEXP (copy, i, j));
+	break;
+      }
+
+  return copy;
+}
+
+/* We have accepted the combination being tried.  Copy any rtl in
+   combine_obstack that was substituted into existing rtl to the real
+   rtl obstack, then release combine_obstack.  The caller must already
+   have used keep_combine_rtx on the new patterns and notes it holds.  */
+
+static void
+keep_combine_storage ()
+{
+  struct undo *undo;
+
+  for (undo = undobuf.undos; undo; undo = undo->next)
+    if (! undo->is_int
+	&& ! _obstack_allocated_p (&combine_obstack, undo->where.r))
+      *undo->where.r = keep_combine_rtx (*undo->where.r);
+
+  rtl_obstack = undobuf.real_obstack;
+  obstack_free (&combine_obstack, undobuf.storage);
+}
 
 /* Find the innermost point within the rtx at LOC, possibly LOC itself,
    where we have an arithmetic expression and return that point.  LOC will
@@ -9,4 +9,9 @@
 #define HOST_BITS_PER_SHORT 16
 #define HOST_BITS_PER_INT 32
 
+/* Size of the stdio buffer given to the assembler output file.  Large
+   initialized tables make for a lot of output, so write it out in
+   bigger chunks than the default.  */
+#define IO_BUFFER_SIZE (64 * 1024)
+
 #include "telf.h"
@@ -8306,6 +8306,11 @@ cse_main (f, nregs, after_loop, file)
   constant_pool_entries_cost = 0;
   val.path_size = 0;
 
+  /* Much of cse edits insns in place rather than through the
+     primitives that track changes.  */
+  insn_chain_epoch++;
+  insn_edit_epoch++;
+
   init_recog ();
   init_alias_analysis ();
 
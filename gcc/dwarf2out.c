@@ -44,6 +44,10 @@ Boston, MA 02111-1307, USA.  */
 #include "dwarf2out.h"
 #include "toplev.h"
 #include "dyn-string.h"
+#include "obstack.h"
+
+#define obstack_chunk_alloc xmalloc
+#define obstack_chunk_free free
 
 /* Decide whether we want to emit frame unwind information for the current
    translation unit.  */
@@ -176,6 +180,8 @@ static unsigned long size_of_uleb128	(unsigned long);
 static unsigned long size_of_sleb128	(long);
 static void output_uleb128		(unsigned long);
 static void output_sleb128		(long);
+static void output_hex_data		(FILE *, char *, unsigned long);
+static char *output_hex_digits		(char *, unsigned long);
 static unsigned reg_number		(rtx);
 
 /* Definitions of defaults for assembler-dependent names of various
@@ -244,7 +250,7 @@ static unsigned reg_number		(rtx);
 
 #ifndef ASM_OUTPUT_DWARF_DATA1
 #define ASM_OUTPUT_DWARF_DATA1(FILE,VALUE) \
-  fprintf ((FILE), "\t%s\t0x%x", ASM_BYTE_OP, (unsigned) (VALUE))
+  output_hex_data ((FILE), ASM_BYTE_OP, (unsigned) (VALUE))
 #endif
 
 #ifndef ASM_OUTPUT_DWARF_DELTA1
@@ -342,24 +348,22 @@ static unsigned reg_number		(rtx);
 
 #ifndef ASM_OUTPUT_DWARF_DATA2
 #define ASM_OUTPUT_DWARF_DATA2(FILE,VALUE) \
-  fprintf ((FILE), "\t%s\t0x%x", UNALIGNED_SHORT_ASM_OP, (unsigned) (VALUE))
+  output_hex_data ((FILE), UNALIGNED_SHORT_ASM_OP, (unsigned) (VALUE))
 #endif
 
 #ifndef ASM_OUTPUT_DWARF_DATA4
 #define ASM_OUTPUT_DWARF_DATA4(FILE,VALUE) \
-  fprintf ((FILE), "\t%s\t0x%x", UNALIGNED_INT_ASM_OP, (unsigned) (VALUE))
+  output_hex_data ((FILE), UNALIGNED_INT_ASM_OP, (unsigned) (VALUE))
 #endif
 
 #ifndef ASM_OUTPUT_DWARF_DATA
 #define ASM_OUTPUT_DWARF_DATA(FILE,VALUE) \
-  fprintf ((FILE), "\t%s\t0x%lx", UNALIGNED_OFFSET_ASM_OP, \
-	   (unsigned long) (VALUE))
+  output_hex_data ((FILE), UNALIGNED_OFFSET_ASM_OP, (unsigned long) (VALUE))
 #endif
 
 #ifndef ASM_OUTPUT_DWARF_ADDR_DATA
 #define ASM_OUTPUT_DWARF_ADDR_DATA(FILE,VALUE) \
-  fprintf ((FILE), "\t%s\t0x%lx", UNALIGNED_WORD_ASM_OP, \
-	   (unsigned long) (VALUE))
+  output_hex_data ((FILE), UNALIGNED_WORD_ASM_OP, (unsigned long) (VALUE))
 #endif
 
 #ifndef ASM_OUTPUT_DWARF_DATA8
@@ -519,6 +523,59 @@ size_of_sleb128 (value)
   return size;
 }
 
+/* Output the pseudo-op OP and VALUE in hexadecimal, with no newline,
+   just as fprintf with "\t%s\t0x%lx" would.  Most of the debugging
+   information is written this way, so it is formatted by hand.  */
+
+static void
+output_hex_data (file, op, value)
+     FILE *file;
+     char *op;
+     unsigned long value;
+{
+  char buf[64];
+  register char *p;
+  register int len = strlen (op);
+
+  if (len > 32)
+    {
+      fprintf (file, "\t%s\t0x%lx", op, value);
+      return;
+    }
+
+  buf[0] = '\t';
+  memcpy (buf + 1, op, len);
+  p = buf + len + 1;
+  *p++ = '\t';
+  *p++ = '0';
+  *p++ = 'x';
+  p = output_hex_digits (p, value);
+  fwrite (buf, 1, p - buf, file);
+}
+
+/* Write VALUE in lowercase hexadecimal at P, and return the end.  */
+
+static char *
+output_hex_digits (p, value)
+     register char *p;
+     register unsigned long value;
+{
+  char digits[2 * sizeof (unsigned long)];
+  register int n = 0;
+
+  do
+    {
+      digits[n++] = "0123456789abcdef"[value & 0xf];
+      value >>= 4;
+    }
+  while (value != 0);
+
+  while (n > 0)
+    *p++ = digits[--n];
+
+  return p;
+}
+
 /* Output an unsigned LEB128 quantity.  */
 
 static void
@@ -526,8 +583,13 @@ output_uleb128 (value)
      register unsigned long value;
 {
   unsigned long save_value = value;
+  char buf[128];
+  register char *p;
 
-  fprintf (asm_out_file, "\t%s\t", ASM_BYTE_OP);
+  buf[0] = '\t';
+  strcpy (buf + 1, ASM_BYTE_OP);
+  p = buf + strlen (buf);
+  *p++ = '\t';
   do
     {
       register unsigned byte = (value & 0x7f);
@@ -536,11 +598,14 @@ output_uleb128 (value)
 	/* More bytes to follow.  */
 	byte |= 0x80;
 
-      fprintf (asm_out_file, "0x%x", byte);
+      *p++ = '0';
+      *p++ = 'x';
+      p = output_hex_digits (p, byte);
       if (value != 0)
-	fprintf (asm_out_file, ",");
+	*p++ = ',';
     }
   while (value != 0);
+  fwrite (buf, 1, p - buf, asm_out_file);
 
   if (flag_debug_asm)
     fprintf (asm_out_file, "\t%s ULEB128 0x%lx", ASM_COMMENT_START, save_value);
@@ -555,8 +620,13 @@ output_sleb128 (value)
   register int more;
   register unsigned byte;
   long save_value = value;
+  char buf[128];
+  register char *p;
 
-  fprintf (asm_out_file, "\t%s\t", ASM_BYTE_OP);
+  buf[0] = '\t';
+  strcpy (buf + 1, ASM_BYTE_OP);
+  p = buf + strlen (buf);
+  *p++ = '\t';
   do
     {
       byte = (value & 0x7f);
@@ -567,12 +637,15 @@ output_sleb128 (value)
       if (more)
 	byte |= 0x80;
 
-      fprintf (asm_out_file, "0x%x", byte);
+      *p++ = '0';
+      *p++ = 'x';
+      p = output_hex_digits (p, byte);
       if (more)
-	fprintf (asm_out_file, ",");
+	*p++ = ',';
     }
 
   while (more);
+  fwrite (buf, 1, p - buf, asm_out_file);
   if (flag_debug_asm)
     fprintf (asm_out_file, "\t%s SLEB128 %ld", ASM_COMMENT_START, save_value);
 }
@@ -886,6 +959,13 @@ static dw_die_ref comp_unit_die;
 /* A list of DIEs with a NULL parent waiting to be relocated.  */
 static limbo_die_node *limbo_die_list = 0;
 
+/* DIEs, attributes and location descriptions are allocated here, as they
+   all last until the end of the compilation.  The DIEs and attributes
+   that get removed are chained for reuse on these lists.  */
+static struct obstack dwarf2out_obstack;
+static dw_die_ref free_dies;
+static dw_attr_ref free_attrs;
+
 /* Pointer to an array of filenames referenced by this compilation unit.  */
 static char **file_table;
 
@@ -970,6 +1050,14 @@ static unsigned abbrev_die_table_in_use;
    abbrev_die_table.  */
 #define ABBREV_DIE_TABLE_INCREMENT 256
 
+/* A hash table of the entries of abbrev_die_table, indexed by a hash of
+   the tag, children and attribute forms.  Each element starts a chain of
+   abbreviation ids, linked through abbrev_hash_chain, which is allocated
+   along with abbrev_die_table.  */
+#define ABBREV_HASH_SIZE 1021
+static unsigned abbrev_hash_table[ABBREV_HASH_SIZE];
+static unsigned *abbrev_hash_chain;
+
 /* A pointer to the base of a table that contains line information
    for each source code line in .text in the compilation unit.  */
 static dw_line_info_ref line_info_table;
@@ -1065,6 +1153,7 @@ static char *dwarf_type_encoding_name	(unsigned);
 static tree decl_ultimate_origin	(tree);
 static tree block_ultimate_origin	(tree);
 static tree decl_class_context		(tree);
+static dw_attr_ref new_attr		(void);
 static void add_dwarf_attr		(dw_die_ref, dw_attr_ref);
 static void add_AT_flag			(dw_die_ref,
 					       enum dwarf_attribute,
@@ -2254,6 +2343,23 @@ decl_class_context (decl)
   return context;
 }
 
+/* Return a new attribute node, reusing one that was removed from its
+   DIE if there is any.  */
+
+static inline dw_attr_ref
+new_attr ()
+{
+  register dw_attr_ref attr = free_attrs;
+
+  if (attr != NULL)
+    free_attrs = attr->dw_attr_next;
+  else
+    attr = (dw_attr_ref) obstack_alloc (&dwarf2out_obstack,
+					sizeof (dw_attr_node));
+
+  return attr;
+}
+
 /* Add an attribute/value pair to a DIE */
 
 static inline void
@@ -2284,7 +2390,7 @@ add_AT_flag (die, attr_kind, flag)
      register enum dwarf_attribute attr_kind;
      register unsigned flag;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2301,7 +2407,7 @@ add_AT_int (die, attr_kind, int_val)
      register enum dwarf_attribute attr_kind;
      register long int int_val;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2318,7 +2424,7 @@ add_AT_unsigned (die, attr_kind, unsigned_val)
      register enum dwarf_attribute attr_kind;
      register unsigned long unsigned_val;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2336,7 +2442,7 @@ add_AT_long_long (die, attr_kind, val_hi, val_low)
      register unsigned long val_hi;
      register unsigned long val_low;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2355,7 +2461,7 @@ add_AT_float (die, attr_kind, length, array)
      register unsigned length;
      register long *array;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2373,7 +2479,7 @@ add_AT_string (die, attr_kind, str)
      register enum dwarf_attribute attr_kind;
      register char *str;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2390,7 +2496,7 @@ add_AT_die_ref (die, attr_kind, targ_die)
      register enum dwarf_attribute attr_kind;
      register dw_die_ref targ_die;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2407,7 +2513,7 @@ add_AT_fde_ref (die, attr_kind, targ_fde)
      register enum dwarf_attribute attr_kind;
      register unsigned targ_fde;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2424,7 +2530,7 @@ add_AT_loc (die, attr_kind, loc)
      register enum dwarf_attribute attr_kind;
      register dw_loc_descr_ref loc;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2441,7 +2547,7 @@ add_AT_addr (die, attr_kind, addr)
      register enum dwarf_attribute attr_kind;
      char *addr;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2458,7 +2564,7 @@ add_AT_lbl_id (die, attr_kind, lbl_id)
      register enum dwarf_attribute attr_kind;
      register char *lbl_id;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2475,7 +2581,7 @@ add_AT_section_offset (die, attr_kind, section)
      register enum dwarf_attribute attr_kind;
      register char *section;
 {
-  register dw_attr_ref attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+  register dw_attr_ref attr = new_attr ();
 
   attr->dw_attr_next = NULL;
   attr->dw_attr = attr_kind;
@@ -2676,7 +2782,10 @@ remove_AT (die, attr_kind)
 	    }
 
       if (removed != 0)
-	free (removed);
+	{
+	  removed->dw_attr_next = free_attrs;
+	  free_attrs = removed;
+	}
     }
 }
 
@@ -2703,10 +2812,12 @@ remove_children (die)
 	  register dw_attr_ref tmp_a = a;
 
 	  a = a->dw_attr_next;
-	  free (tmp_a);
+	  tmp_a->dw_attr_next = free_attrs;
+	  free_attrs = tmp_a;
 	}
 
-      free (tmp_die);
+      tmp_die->die_sib = free_dies;
+      free_dies = tmp_die;
     }
 }
 
@@ -2744,7 +2855,12 @@ new_die (tag_value, parent_die)
      register enum dwarf_tag tag_value;
      register dw_die_ref parent_die;
 {
-  register dw_die_ref die = (dw_die_ref) xmalloc (sizeof (die_node));
+  register dw_die_ref die = free_dies;
+
+  if (die != NULL)
+    free_dies = die->die_sib;
+  else
+    die = (dw_die_ref) obstack_alloc (&dwarf2out_obstack, sizeof (die_node));
 
   die->die_tag = tag_value;
   die->die_abbrev = 0;
@@ -2845,7 +2961,8 @@ new_loc_descr (op, oprnd1, oprnd2)
      register unsigned long oprnd2;
 {
   register dw_loc_descr_ref descr
-    = (dw_loc_descr_ref) xmalloc (sizeof (dw_loc_descr_node));
+    = (dw_loc_descr_ref) obstack_alloc (&dwarf2out_obstack,
+					sizeof (dw_loc_descr_node));
 
   descr->dw_loc_next = NULL;
   descr->dw_loc_opc = op;
@@ -3026,7 +3143,7 @@ add_sibling_attributes(die)
   register dw_attr_ref attr;
   if (die != comp_unit_die && die->die_child != NULL)
     {
-      attr = (dw_attr_ref) xmalloc (sizeof (dw_attr_node));
+      attr = new_attr ();
       attr->dw_attr_next = NULL;
       attr->dw_attr = DW_AT_sibling;
       attr->dw_attr_val.val_class = dw_val_class_die_ref;
@@ -3058,7 +3175,16 @@ build_abbrev_table (die)
   register unsigned long n_alloc;
   register dw_die_ref c;
   register dw_attr_ref d_attr, a_attr;
-  for (abbrev_id = 1; abbrev_id < abbrev_die_table_in_use; ++abbrev_id)
+  register unsigned hash;
+
+  hash = die->die_tag * 2 + (die->die_child != NULL);
+  for (d_attr = die->die_attr; d_attr != NULL; d_attr = d_attr->dw_attr_next)
+    hash = (hash * 67 + d_attr->dw_attr * 31
+	    + value_format (&d_attr->dw_attr_val));
+  hash %= ABBREV_HASH_SIZE;
+
+  for (abbrev_id = abbrev_hash_table[hash]; abbrev_id != 0;
+       abbrev_id = abbrev_hash_chain[abbrev_id])
     {
       register dw_die_ref abbrev = abbrev_die_table[abbrev_id];
 
@@ -3086,7 +3212,7 @@ build_abbrev_table (die)
 	}
     }
 
-  if (abbrev_id >= abbrev_die_table_in_use)
+  if (abbrev_id == 0)
     {
       if (abbrev_die_table_in_use >= abbrev_die_table_allocated)
 	{
@@ -3094,14 +3220,19 @@ build_abbrev_table (die)
 	  abbrev_die_table 
 	    = (dw_die_ref *) xrealloc (abbrev_die_table,
 				       sizeof (dw_die_ref) * n_alloc);
+	  abbrev_hash_chain
+	    = (unsigned *) xrealloc (abbrev_hash_chain,
+				     sizeof (unsigned) * n_alloc);
 
 	  zero_memory ((char *) &abbrev_die_table[abbrev_die_table_allocated],
 		 (n_alloc - abbrev_die_table_allocated) * sizeof (dw_die_ref));
 	  abbrev_die_table_allocated = n_alloc;
 	}
 
-      ++abbrev_die_table_in_use;
+      abbrev_id = abbrev_die_table_in_use++;
       abbrev_die_table[abbrev_id] = die;
+      abbrev_hash_chain[abbrev_id] = abbrev_hash_table[hash];
+      abbrev_hash_table[hash] = abbrev_id;
     }
 
   die->die_abbrev = abbrev_id;
@@ -8301,6 +8432,8 @@ dwarf2out_init (asm_out_file, main_input_filename)
   /* Remember the name of the primary input file.  */
   primary_filename = main_input_filename;
 
+  gcc_obstack_init (&dwarf2out_obstack);
+
   /* Allocate the initial hunk of the file_table.  */
   file_table = (char **) xmalloc (FILE_TABLE_INCREMENT * sizeof (char *));
   zero_memory ((char *) file_table, FILE_TABLE_INCREMENT * sizeof (char *));
@@ -8332,6 +8465,8 @@ dwarf2out_init (asm_out_file, main_input_filename)
 			      * sizeof (dw_die_ref));
   zero_memory ((char *) abbrev_die_table,
 	 ABBREV_DIE_TABLE_INCREMENT * sizeof (dw_die_ref));
+  abbrev_hash_chain
+    = (unsigned *) xmalloc (ABBREV_DIE_TABLE_INCREMENT * sizeof (unsigned));
   abbrev_die_table_allocated = ABBREV_DIE_TABLE_INCREMENT;
   /* Zero-th entry is allocated, but unused */
   abbrev_die_table_in_use = 1;
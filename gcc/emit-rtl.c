@@ -1386,6 +1386,7 @@ set_new_first_and_last_insn (first, last)
   first_insn = first;
   last_insn = last;
   cur_insn_uid = 0;
+  insn_chain_epoch++;
 
   for (insn = first; insn; insn = NEXT_INSN (insn))
     cur_insn_uid = MAX (cur_insn_uid, INSN_UID (insn));
@@ -2177,6 +2178,7 @@ void
 add_insn (insn)
      register rtx insn;
 {
+  insn_chain_epoch++;
   PREV_INSN (insn) = last_insn;
   NEXT_INSN (insn) = 0;
 
@@ -2200,6 +2202,7 @@ add_insn_after (insn, after)
 {
   rtx next = NEXT_INSN (after);
 
+  insn_chain_epoch++;
   if (optimize && INSN_DELETED_P (after))
     abort ();
 
@@ -2248,6 +2251,7 @@ add_insn_before (insn, before)
 {
   rtx prev = PREV_INSN (before);
 
+  insn_chain_epoch++;
   if (optimize && INSN_DELETED_P (before))
     abort ();
 
@@ -2293,6 +2297,8 @@ remove_insn (insn)
 {
   rtx next = NEXT_INSN (insn);
   rtx prev = PREV_INSN (insn);
+
+  insn_chain_epoch++;
   if (prev)
     {
       NEXT_INSN (prev) = next;
@@ -2350,6 +2356,7 @@ void
 delete_insns_since (from)
      rtx from;
 {
+  insn_chain_epoch++;
   if (from == 0)
     first_insn = 0;
   else
@@ -2371,6 +2378,8 @@ void
 reorder_insns (from, to, after)
      rtx from, to, after;
 {
+  insn_chain_epoch++;
+
   /* Splice this bunch out of where it is now.  */
   if (PREV_INSN (from))
     NEXT_INSN (PREV_INSN (from)) = NEXT_INSN (to);
@@ -2782,6 +2791,7 @@ emit_insns_after (first, after)
 
   after_after = NEXT_INSN (after);
 
+  insn_chain_epoch++;
   NEXT_INSN (after) = first;
   PREV_INSN (first) = after;
   NEXT_INSN (last) = after_after;
@@ -3195,6 +3205,7 @@ init_emit ()
   last_insn = NULL;
   sequence_rtl_expr = NULL;
   cur_insn_uid = 1;
+  insn_chain_epoch++;
   reg_rtx_no = LAST_VIRTUAL_REGISTER + 1;
   last_linenum = 0;
   last_filename = 0;
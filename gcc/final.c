@@ -338,20 +338,54 @@ static rtx *uid_align;
 static int *uid_shuid;
 static struct label_alignment *label_align;
 
-static void
-print_wint(FILE *file, HOST_WIDE_INT value)
+/* Store in BUF the text of VALUE as print_wint writes it, without a
+   terminating null, and return its length.  BUF needs room for
+   MAX_WINT_CHARS characters.  This is done by hand rather than with
+   sprintf since it is called for every element of initialized data.  */
+
+int
+sprint_wint(char *buf, HOST_WIDE_INT value)
 {
-  const char *fmt = HOST_WIDE_INT_PRINT_DEC;
+  char digits[MAX_WINT_CHARS];
+  unsigned int uvalue = value;
+  int len = 0, n = 0;
+
+  if (value < 0)
+    {
+      buf[len++] = '-';
+      uvalue = -uvalue;
+    }
+
   if (flag_hex_asm)
     {
-      fmt = HOST_WIDE_INT_PRINT_HEX;
-      if (value < 0)
+      buf[len++] = '0';
+      buf[len++] = 'x';
+      do
         {
-          fputc('-', file);
-          value = -value;
+          digits[n++] = "0123456789abcdef"[uvalue & 15];
+          uvalue >>= 4;
         }
+      while (uvalue);
     }
-  fprintf(file, fmt, value);
+  else
+    do
+      {
+        digits[n++] = '0' + uvalue % 10;
+        uvalue /= 10;
+      }
+    while (uvalue);
+
+  while (n > 0)
+    buf[len++] = digits[--n];
+  return len;
+}
+
+static void
+print_wint(FILE *file, HOST_WIDE_INT value)
+{
+  char buf[MAX_WINT_CHARS];
+
+  fwrite(buf, 1, sprint_wint(buf, value), file);
 }
 
 /* Indicate that branch shortening hasn't yet been done.  */
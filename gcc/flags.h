@@ -450,3 +450,7 @@ extern enum graph_dump_types graph_dump_format;
 
 /* Nonzero if ASM output should use hex instead of decimal.  */
 extern int flag_hex_asm;
+
+/* Nonzero if runs of integer data should be output with several values
+   per directive.  */
+extern int flag_pack_data;
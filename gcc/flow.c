@@ -979,6 +979,8 @@ delete_unreachable_blocks ()
 		{
 		  NOTE_LINE_NUMBER (insn) = NOTE_INSN_DELETED;
 		  NOTE_SOURCE_FILE (insn) = 0;
+		  insn_chain_epoch++;
+		  insn_edit_epoch++;
 		}
 	    }
 	}
@@ -1117,6 +1119,8 @@ delete_block (i)
 		PUT_CODE (insn, NOTE);
 		NOTE_LINE_NUMBER (insn) = NOTE_INSN_DELETED;
 		NOTE_SOURCE_FILE (insn) = 0;
+		insn_chain_epoch++;
+		insn_edit_epoch++;
 		if (GET_CODE (NEXT_INSN (insn)) != BARRIER)
 		  abort ();
 		delete_insn (NEXT_INSN (insn));
@@ -1318,6 +1322,8 @@ record_volatile_insns (f)
 	      PUT_CODE (insn, NOTE);
 	      NOTE_LINE_NUMBER (insn) = NOTE_INSN_DELETED;
 	      NOTE_SOURCE_FILE (insn) = 0;
+	      insn_chain_epoch++;
+	      insn_edit_epoch++;
 	    }
 	}
 
@@ -1456,6 +1462,10 @@ life_analysis_1 (f, nregs)
      of all the blocks that can transfer control to that block.
      The process continues until it reaches a fixed point.  */
 
+  /* Nothing is changed until the final pass below, so the same
+     dependences between MEMs can be asked for in every iteration.  */
+  begin_alias_memo ();
+
   first_pass = 1;
   changed = 1;
   while (changed)
@@ -1545,6 +1555,8 @@ life_analysis_1 (f, nregs)
       first_pass = 0;
     }
 
+  end_alias_memo ();
+
   /* The only pseudos that are live at the beginning of the function are
      those that were not set anywhere in the function.  local-alloc doesn't
      know how to handle these correctly, so mark them as not local to any
@@ -1818,6 +1830,8 @@ propagate_block (old, first, last, final, significant, bnum)
 	      PUT_CODE (insn, NOTE);
 	      NOTE_LINE_NUMBER (insn) = NOTE_INSN_DELETED;
 	      NOTE_SOURCE_FILE (insn) = 0;
+	      insn_chain_epoch++;
+	      insn_edit_epoch++;
 
 	      /* CC0 is now known to be dead.  Either this insn used it,
 		 in which case it doesn't anymore, or clobbered it,
@@ -1838,6 +1852,8 @@ propagate_block (old, first, last, final, significant, bnum)
 		      PUT_CODE (p, NOTE);
 		      NOTE_LINE_NUMBER (p) = NOTE_INSN_DELETED;
 		      NOTE_SOURCE_FILE (p) = 0;
+		      insn_chain_epoch++;
+		      insn_edit_epoch++;
 		    }
 		}
 	      goto flushed;
@@ -2682,6 +2698,8 @@ find_auto_inc (needed, x, insn)
 	      PUT_CODE (incr, NOTE);
 	      NOTE_LINE_NUMBER (incr) = NOTE_INSN_DELETED;
 	      NOTE_SOURCE_FILE (incr) = 0;
+	      insn_chain_epoch++;
+	      insn_edit_epoch++;
 	    }
 
 	  if (regno >= FIRST_PSEUDO_REGISTER)
@@ -3123,6 +3141,8 @@ try_pre_increment_1 (insn)
       PUT_CODE (insn, NOTE);
       NOTE_LINE_NUMBER (insn) = NOTE_INSN_DELETED;
       NOTE_SOURCE_FILE (insn) = 0;
+      insn_chain_epoch++;
+      insn_edit_epoch++;
       /* Count a reference to this reg for the increment
 	 insn we are deleting.  When a reg is incremented.
 	 spilling it is worse, so we want to make that
@@ -430,6 +430,26 @@ struct fixup_replacement
   rtx new;
   struct fixup_replacement *next;
 };
+
+/* While purge_addressof runs, a summary for each insn, indexed by
+   INSN_UID, of the REGs and MEMs its pattern mentions.  Each REG or
+   MEM sets one of the low bits, chosen from its address, so that
+   fixup_var_refs_insns can pass over an insn whose summary lacks the
+   bit for VAR.  A zero entry has not been computed; entries are cleared
+   whenever the insn may have changed.  Insns whose uid is not below
+   insn_refs_max_uid always get a full look.  */
+
+static unsigned int *insn_refs;
+static int insn_refs_max_uid;
+
+/* The insn purge_addressof is changing, whose summary is never used.  */
+
+static rtx insn_refs_changing;
+
+#define INSN_REFS_VALID		((unsigned int) 1 << 31)
+#define INSN_REFS_EXTRACT	((unsigned int) 1 << 30)
+#define INSN_REFS_BIT(X) \
+  ((unsigned int) 1 << (((unsigned long) (X) >> 3) % 29))
    
 /* Forward declarations.  */
 
@@ -442,6 +462,8 @@ static void put_reg_into_stack	(struct function *, rtx, tree,
 static void fixup_var_refs	(rtx, enum machine_mode, int);
 static struct fixup_replacement
   *find_fixup_replacement	(struct fixup_replacement **, rtx);
+static int note_insn_ref		(rtx *, void *);
+static int insn_may_refer_to	(rtx, rtx);
 static void fixup_var_refs_insns (rtx, enum machine_mode, int,
 					rtx, int);
 static void fixup_var_refs_1	(rtx, enum machine_mode, rtx *, rtx,
@@ -1656,6 +1678,63 @@ find_fixup_replacement (replacements, x)
   return p;
 }
 
+/* Called via for_each_rtx on the pattern of an insn.  Add *X to the
+   summary DATA points to.  */
+
+static int
+note_insn_ref (x, data)
+     rtx *x;
+     void *data;
+{
+  unsigned int *refs = (unsigned int *) data;
+
+  if (*x == 0)
+    return 0;
+
+  switch (GET_CODE (*x))
+    {
+    case REG:
+    case MEM:
+      *refs |= INSN_REFS_BIT (*x);
+      break;
+
+    case SIGN_EXTRACT:
+    case ZERO_EXTRACT:
+      /* fixup_var_refs_1 may call optimize_bit_field on these whatever
+	 VAR is.  */
+      *refs |= INSN_REFS_EXTRACT;
+      break;
+
+    default:
+      break;
+    }
+
+  return 0;
+}
+
+/* Return nonzero unless the summary of INSN shows that fixing up VAR
+   cannot change its pattern.  */
+
+static int
+insn_may_refer_to (insn, var)
+     rtx insn, var;
+{
+  unsigned int *refs;
+
+  if (insn_refs == 0 || INSN_UID (insn) >= insn_refs_max_uid
+      || insn == insn_refs_changing)
+    return 1;
+
+  refs = &insn_refs[INSN_UID (insn)];
+  if (*refs == 0)
+    {
+      *refs = INSN_REFS_VALID;
+      for_each_rtx (&PATTERN (insn), note_insn_ref, refs);
+    }
+
+  return (*refs & (INSN_REFS_EXTRACT | INSN_REFS_BIT (var))) != 0;
+}
+
 /* Scan the insn-chain starting with INSN for refs to VAR
    and fix them up.  TOPLEVEL is nonzero if this chain is the
    main chain of insns for the current function.  */
@@ -1678,11 +1757,13 @@ fixup_var_refs_insns (var, promoted_mode, unsignedp, insn, toplevel)
 
       if (GET_RTX_CLASS (GET_CODE (insn)) == 'i')
 	{
+	  int may_refer = insn_may_refer_to (insn, var);
+
 	  /* If this is a CLOBBER of VAR, delete it.
 
 	     If it has a REG_LIBCALL note, delete the REG_LIBCALL
 	     and REG_RETVAL notes too.  */
- 	  if (GET_CODE (PATTERN (insn)) == CLOBBER
+ 	  if (may_refer && GET_CODE (PATTERN (insn)) == CLOBBER
 	      && (XEXP (PATTERN (insn), 0) == var
 		  || (GET_CODE (XEXP (PATTERN (insn), 0)) == CONCAT
 		      && (XEXP (XEXP (PATTERN (insn), 0), 0) == var
@@ -1708,7 +1789,7 @@ fixup_var_refs_insns (var, promoted_mode, unsignedp, insn, toplevel)
 	     Similarly if this is storing VAR from a register from which
 	     it was loaded in the previous insn.  This will occur
 	     when an ADDRESSOF was made for an arglist slot.  */
-	  else if (toplevel
+	  else if (may_refer && toplevel
 		   && (set = single_set (insn)) != 0
 		   && SET_DEST (set) == var
 		   /* If this represents the result of an insn group,
@@ -1783,8 +1864,9 @@ fixup_var_refs_insns (var, promoted_mode, unsignedp, insn, toplevel)
 		 If it allocated a pseudo for any replacement, we copy into
 		 it here.  */
 
-	      fixup_var_refs_1 (var, promoted_mode, &PATTERN (insn), insn,
-				&replacements);
+	      if (may_refer)
+		fixup_var_refs_1 (var, promoted_mode, &PATTERN (insn), insn,
+				  &replacements);
 
 	      /* If this is last_parm_insn, and any instructions were output
 		 after it to fix it up, then we must set last_parm_insn to
@@ -1840,6 +1922,10 @@ fixup_var_refs_insns (var, promoted_mode, unsignedp, insn, toplevel)
 	    if (GET_CODE (note) != INSN_LIST)
 	      XEXP (note, 0)
 		= walk_fixup_memory_subreg (XEXP (note, 0), insn, 1);
+
+	  if (may_refer && insn_refs != 0
+	      && INSN_UID (insn) < insn_refs_max_uid)
+	    insn_refs[INSN_UID (insn)] = 0;
 	}
       insn = next;
     }
@@ -2964,15 +3050,33 @@ purge_addressof (insns)
      rtx insns;
 {
   rtx insn;
+
+  /* purge_addressof_1 rewrites patterns in place.  */
+  insn_chain_epoch++;
+  insn_edit_epoch++;
+
+  /* Each ADDRESSOF put into the stack makes fixup_var_refs look at the
+     whole function; summaries let it skip most insns.  */
+  insn_refs_max_uid = get_max_uid ();
+  insn_refs = (unsigned int *) xcalloc (insn_refs_max_uid,
+					sizeof (unsigned int));
+
   for (insn = insns; insn; insn = NEXT_INSN (insn))
     if (GET_CODE (insn) == INSN || GET_CODE (insn) == JUMP_INSN
 	|| GET_CODE (insn) == CALL_INSN)
       {
+	insn_refs_changing = insn;
 	purge_addressof_1 (&PATTERN (insn), insn,
 			   asm_noperands (PATTERN (insn)) > 0, 0);
 	purge_addressof_1 (&REG_NOTES (insn), NULL_RTX, 0, 0);
+	insn_refs_changing = 0;
+	if (INSN_UID (insn) < insn_refs_max_uid)
+	  insn_refs[INSN_UID (insn)] = 0;
       }
   purge_addressof_replacements = 0;
+
+  free (insn_refs);
+  insn_refs = 0;
 }
 
 /* Pass through the INSNS of function FNDECL and convert virtual register
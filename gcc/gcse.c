@@ -640,6 +640,11 @@ gcse_main (f, file)
   /* Assume that we do not need to run jump optimizations after gcse.  */
   run_jump_opt_after_gcse = 0;
 
+  /* The gcse passes edit insns in place rather than through the
+     primitives that track changes.  */
+  insn_chain_epoch++;
+  insn_edit_epoch++;
+
   /* For calling dump_foo fns from gdb.  */
   debug_stderr = stderr;
   gcse_file = file;
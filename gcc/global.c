@@ -116,29 +116,79 @@ static int *reg_may_share;
 #define INT_BITS HOST_BITS_PER_WIDE_INT
 #define INT_TYPE HOST_WIDE_INT
 
-/* max_allocno by max_allocno array of bits,
-   recording whether two allocno's conflict (can't go in the same
+/* The allocnos that one allocno conflicts with (can't go in the same
    hardware register).
 
-   `conflicts' is not symmetric; a conflict between allocno's i and j
-   is recorded either in element i,j or in element j,i.  */
+   If BITS is nonzero, it is a row of allocno_row_words words with a bit
+   set for each conflicting allocno.  Otherwise the conflicting allocnos
+   are listed in the first NUM of the ALLOC elements of VEC.
 
-static INT_TYPE *conflicts;
+   When there are few allocnos, every row is a bit vector and `conflicts'
+   is just the old max_allocno by max_allocno conflict matrix.  In big
+   functions the rows start out as vectors, which keeps the graph linear
+   in the number of conflicts, and a row is only turned into bits once
+   the vector would become bigger than that.
 
-/* Number of ints require to hold max_allocno bits.
-   This is the length of a row in `conflicts'.  */
+   While global_conflicts is running the rows are not symmetric; a conflict
+   between allocno's i and j is recorded either in row i or in row j,
+   and vectors may contain duplicates.  finish_conflicts then records each
+   conflict in both rows, and leaves each vector sorted in increasing order
+   without duplicates.  */
 
-static int allocno_row_words;
+struct allocno_conflicts
+{
+  INT_TYPE *bits;
+  int *vec;
+  int num;
+  int alloc;
+};
+
+static struct allocno_conflicts *conflicts;
 
-/* Two macros to test or store 1 in an element of `conflicts'.  */
+/* Functions with at most this many allocnos use a bit vector
+   for every row of `conflicts'.  */
+
+#define CONFLICT_MATRIX_MAX_ALLOCNOS 1024
+
+/* Number of ints require to hold max_allocno bits.
+   This is the length of a bit vector row in `conflicts'.  */
 
-#define CONFLICTP(I, J) \
- (conflicts[(I) * allocno_row_words + (J) / INT_BITS]	\
-  & ((INT_TYPE) 1 << ((J) % INT_BITS)))
+static int allocno_row_words;
 
-#define SET_CONFLICT(I, J) \
- (conflicts[(I) * allocno_row_words + (J) / INT_BITS]	\
-  |= ((INT_TYPE) 1 << ((J) % INT_BITS)))
+/* Execute CODE for each allocno J that conflicts with ALLOCNO,
+   in increasing order of J.  Only valid after finish_conflicts.  */
+
+#define EXECUTE_IF_CONFLICT(ALLOCNO, J, CODE)				\
+do {									\
+  struct allocno_conflicts *conflict_ = &conflicts[ALLOCNO];		\
+									\
+  if (conflict_->bits)							\
+    {									\
+      int word_num_;							\
+									\
+      for (word_num_ = 0; word_num_ < allocno_row_words; word_num_++)	\
+	{								\
+	  HOST_WIDE_UINT word_ = conflict_->bits[word_num_];		\
+									\
+	  for ((J) = word_num_ * INT_BITS; word_ != 0; word_ >>= 1, (J)++) \
+	    if (word_ & 1)						\
+	      {								\
+		CODE;							\
+	      }								\
+	}								\
+    }									\
+  else									\
+    {									\
+      int *ptr_ = conflict_->vec;					\
+      int *end_ = ptr_ + conflict_->num;				\
+									\
+      for (; ptr_ < end_; ptr_++)					\
+	{								\
+	  (J) = *ptr_;							\
+	  CODE;								\
+	}								\
+    }									\
+} while (0)
 
 /* Set of hard regs currently live (during scan of all insns).  */
 
@@ -216,6 +266,15 @@ static int local_reg_live_length[FIRST_PSEUDO_REGISTER];
 
 static INT_TYPE *allocnos_live;
 
+/* The same set as a vector of N_ALLOCNOS_LIVE allocnos in no particular
+   order, so that the live allocnos can be visited without scanning
+   all of allocnos_live.  ALLOCNO_LIVE_INDEX gives the position of each
+   live allocno in ALLOCNO_LIVE_VEC.  */
+
+static int *allocno_live_vec;
+static int *allocno_live_index;
+static int n_allocnos_live;
+
 /* Test, set or clear bit number I in allocnos_live,
    a bit vector indexed by allocno.  */
 
@@ -223,10 +282,25 @@ static INT_TYPE *allocnos_live;
   (allocnos_live[(I) / INT_BITS] & ((INT_TYPE) 1 << ((I) % INT_BITS)))
 
 #define SET_ALLOCNO_LIVE(I) \
-  (allocnos_live[(I) / INT_BITS] |= ((INT_TYPE) 1 << ((I) % INT_BITS)))
+do {									\
+  if (! ALLOCNO_LIVE_P (I))						\
+    {									\
+      allocnos_live[(I) / INT_BITS] |= ((INT_TYPE) 1 << ((I) % INT_BITS)); \
+      allocno_live_index[I] = n_allocnos_live;				\
+      allocno_live_vec[n_allocnos_live++] = (I);			\
+    }									\
+} while (0)
 
 #define CLEAR_ALLOCNO_LIVE(I) \
-  (allocnos_live[(I) / INT_BITS] &= ~((INT_TYPE) 1 << ((I) % INT_BITS)))
+do {									\
+  if (ALLOCNO_LIVE_P (I))						\
+    {									\
+      int last_ = allocno_live_vec[--n_allocnos_live];			\
+      allocnos_live[(I) / INT_BITS] &= ~((INT_TYPE) 1 << ((I) % INT_BITS)); \
+      allocno_live_vec[allocno_live_index[I]] = last_;			\
+      allocno_live_index[last_] = allocno_live_index[I];		\
+    }									\
+} while (0)
 
 /* This is turned off because it doesn't work right for DImode.
    (And it is only used for DImode, so the other cases are worthless.)
@@ -277,6 +351,12 @@ static void mark_reg_death	(rtx);
 static void mark_reg_live_nc	(int, enum machine_mode);
 static void set_preference	(rtx, rtx);
 static void dump_conflicts	(FILE *);
+static void record_live_conflicts (int);
+static void add_conflict	(int, int);
+static int squeeze_conflicts	(struct allocno_conflicts *);
+static int int_compare		(const void *, const void *);
+static void finish_conflicts	(void);
+static int conflict_p		(int, int);
 static void reg_becomes_live	(rtx, rtx);
 static void reg_dies		(int, enum machine_mode);
 static void build_insn_chain	(rtx);
@@ -450,15 +530,36 @@ global_init (FILE *file)
 
       allocno_row_words = (max_allocno + INT_BITS - 1) / INT_BITS;
 
+      conflicts
+	= (struct allocno_conflicts *) obstack_alloc (&global_obstack,
+						      max_allocno
+						      * sizeof (struct allocno_conflicts));
+      zero_memory ((char *) conflicts,
+		   max_allocno * sizeof (struct allocno_conflicts));
+
       /* We used to use alloca here, but the size of what it would try to
          allocate would occasionally cause it to exceed the stack limit and
          cause unpredictable core dumps.  Some examples were > 2Mb in size.  */
-      conflicts = (INT_TYPE *) xmalloc (max_allocno * allocno_row_words
-				        * sizeof (INT_TYPE));
+      if (max_allocno <= CONFLICT_MATRIX_MAX_ALLOCNOS)
+	{
+	  INT_TYPE *matrix
+	    = (INT_TYPE *) obstack_alloc (&global_obstack,
+					  max_allocno * allocno_row_words
+					  * sizeof (INT_TYPE));
+
+	  zero_memory ((char *) matrix,
+		       max_allocno * allocno_row_words * sizeof (INT_TYPE));
+	  for (i = 0; i < (size_t) max_allocno; i++)
+	    conflicts[i].bits = matrix + i * allocno_row_words;
+	}
 
       allocnos_live = (INT_TYPE *) obstack_alloc (&global_obstack,
 						  (allocno_row_words
 						   * sizeof (INT_TYPE)));
+      allocno_live_vec = (int *) obstack_alloc (&global_obstack,
+						max_allocno * sizeof (int));
+      allocno_live_index = (int *) obstack_alloc (&global_obstack,
+						  max_allocno * sizeof (int));
 
   zero_memory ((char *) hard_reg_conflicts, max_allocno * sizeof (HARD_REG_SET));
   zero_memory ((char *) hard_reg_preferences, max_allocno * sizeof (HARD_REG_SET));
@@ -467,8 +568,6 @@ global_init (FILE *file)
   zero_memory ((char *) hard_reg_full_preferences,
 	 max_allocno * sizeof (HARD_REG_SET));
   zero_memory ((char *) regs_someone_prefers, max_allocno * sizeof (HARD_REG_SET));
-  zero_memory ((char *) conflicts,
-	 max_allocno * allocno_row_words * sizeof (INT_TYPE));
 
   /* If there is work to be done (at least one reg to allocate),
      perform global conflict analysis and allocate the regs.  */
@@ -480,6 +579,8 @@ global_init (FILE *file)
 
       global_conflicts ();
 
+      finish_conflicts ();
+
       /* Eliminate conflicts between pseudos and eliminable registers.  If
 	 the register is not eliminated, the pseudo won't really be able to
 	 live in the eliminable register, so the conflict doesn't matter.
@@ -592,8 +693,11 @@ global_alloc (FILE *file)
     build_insn_chain (get_insns ());
     retval = reload (get_insns (), 1, file);
 
+    for (i = 0; i < max_allocno; i++)
+      if (conflicts[i].vec)
+        free (conflicts[i].vec);
+
     obstack_free (&global_obstack, NULL);
-    free (conflicts);
 
     return retval;
 }
@@ -652,6 +756,7 @@ global_conflicts ()
   for (b = 0; b < n_basic_blocks; b++)
     {
       zero_memory ((char *) allocnos_live, allocno_row_words * sizeof (INT_TYPE));
+      n_allocnos_live = 0;
 
       /* Initialize table of registers currently live
 	 to the state at the beginning of this basic block.
@@ -817,10 +922,8 @@ expand_preferences ()
 	if (REG_NOTE_KIND (link) == REG_DEAD
 	    && GET_CODE (XEXP (link, 0)) == REG
 	    && reg_allocno[REGNO (XEXP (link, 0))] >= 0
-	    && ! CONFLICTP (reg_allocno[REGNO (SET_DEST (set))],
-			    reg_allocno[REGNO (XEXP (link, 0))])
-	    && ! CONFLICTP (reg_allocno[REGNO (XEXP (link, 0))],
-			    reg_allocno[REGNO (SET_DEST (set))]))
+	    && ! conflict_p (reg_allocno[REGNO (SET_DEST (set))],
+			     reg_allocno[REGNO (XEXP (link, 0))]))
 	  {
 	    int a1 = reg_allocno[REGNO (SET_DEST (set))];
 	    int a2 = reg_allocno[REGNO (XEXP (link, 0))];
@@ -856,6 +959,11 @@ prune_preferences ()
 {
   int i, j;
   int allocno;
+  int *allocno_order_pos
+    = (int *) obstack_alloc (&global_obstack, max_allocno * sizeof (int));
+
+  for (i = 0; i < max_allocno; i++)
+    allocno_order_pos[allocno_order[i]] = i;
   
   /* Scan least most important to most important.
      For each allocno, remove from preferences registers that cannot be used,
@@ -889,18 +997,18 @@ prune_preferences ()
 	 don't exclude them unless we are of a smaller size (in which case
 	 we want to give the lower-priority allocno the first chance for
 	 these registers).  */
-      for (j = i + 1; j < max_allocno; j++)
-	if (CONFLICTP (allocno, allocno_order[j])
-	    || CONFLICTP (allocno_order[j], allocno))
-	  {
-	    COPY_HARD_REG_SET (temp,
-			       hard_reg_full_preferences[allocno_order[j]]);
-	    if (allocno_size[allocno_order[j]] <= allocno_size[allocno])
-	      AND_COMPL_HARD_REG_SET (temp,
-				      hard_reg_full_preferences[allocno]);
-			       
-	    IOR_HARD_REG_SET (regs_someone_prefers[allocno], temp);
-	  }
+      EXECUTE_IF_CONFLICT (allocno, j,
+	{
+	  if (allocno_order_pos[j] > i)
+	    {
+	      COPY_HARD_REG_SET (temp, hard_reg_full_preferences[j]);
+	      if (allocno_size[j] <= allocno_size[allocno])
+		AND_COMPL_HARD_REG_SET (temp,
+					hard_reg_full_preferences[allocno]);
+
+	      IOR_HARD_REG_SET (regs_someone_prefers[allocno], temp);
+	    }
+	});
     }
 }
 
@@ -1212,12 +1320,10 @@ find_reg (allocno, losers, alt_regs_p, accept_call_clobbered, retrying)
 	}
       /* For each other pseudo-reg conflicting with this one,
 	 mark it as conflicting with the hard regs this one occupies.  */
-      lim = allocno;
-      for (j = 0; j < max_allocno; j++)
-	if (CONFLICTP (lim, j) || CONFLICTP (j, lim))
-	  {
-	    IOR_HARD_REG_SET (hard_reg_conflicts[j], this_reg);
-	  }
+      EXECUTE_IF_CONFLICT (allocno, j,
+	{
+	  IOR_HARD_REG_SET (hard_reg_conflicts[j], this_reg);
+	});
     }
 }
 
@@ -1270,32 +1376,16 @@ record_one_conflict (regno)
   if (regno < FIRST_PSEUDO_REGISTER)
     /* When a hard register becomes live,
        record conflicts with live pseudo regs.  */
-    for (j = 0; j < max_allocno; j++)
-      {
-	if (ALLOCNO_LIVE_P (j))
-	  SET_HARD_REG_BIT (hard_reg_conflicts[j], regno);
-      }
+    for (j = 0; j < n_allocnos_live; j++)
+      SET_HARD_REG_BIT (hard_reg_conflicts[allocno_live_vec[j]], regno);
   else
     /* When a pseudo-register becomes live,
        record conflicts first with hard regs,
        then with other pseudo regs.  */
     {
       register int ialloc = reg_allocno[regno];
-      register int ialloc_prod = ialloc * allocno_row_words;
       IOR_HARD_REG_SET (hard_reg_conflicts[ialloc], hard_regs_live);
-      for (j = allocno_row_words - 1; j >= 0; j--)
-	{
-#if 0
-	  int k;
-	  for (k = 0; k < n_no_conflict_pairs; k++)
-	    if (! ((j == no_conflict_pairs[k].allocno1
-		    && ialloc == no_conflict_pairs[k].allocno2)
-		   ||
-		   (j == no_conflict_pairs[k].allocno2
-		    && ialloc == no_conflict_pairs[k].allocno1)))
-#endif /* 0 */
-	      conflicts[ialloc_prod + j] |= allocnos_live[j];
-	}
+      record_live_conflicts (ialloc);
     }
 }
 
@@ -1310,17 +1400,177 @@ record_conflicts (allocno_vec, len)
      register int len;
 {
   register int allocno;
-  register int j;
-  register int ialloc_prod;
 
   while (--len >= 0)
     {
       allocno = allocno_vec[len];
-      ialloc_prod = allocno * allocno_row_words;
       IOR_HARD_REG_SET (hard_reg_conflicts[allocno], hard_regs_live);
-      for (j = allocno_row_words - 1; j >= 0; j--)
-	conflicts[ialloc_prod + j] |= allocnos_live[j];
+      record_live_conflicts (allocno);
+    }
+}
+
+/* Record in the row of ALLOCNO that it conflicts with
+   all allocnos currently live.  */
+
+static void
+record_live_conflicts (allocno)
+     int allocno;
+{
+  register INT_TYPE *bits = conflicts[allocno].bits;
+  register int j;
+
+  if (bits)
+    for (j = allocno_row_words - 1; j >= 0; j--)
+      bits[j] |= allocnos_live[j];
+  else
+    for (j = 0; j < n_allocnos_live; j++)
+      add_conflict (allocno, allocno_live_vec[j]);
+}
+
+/* Record a conflict with allocno J in the row of ALLOCNO.  */
+
+static void
+add_conflict (allocno, j)
+     int allocno, j;
+{
+  register struct allocno_conflicts *c = &conflicts[allocno];
+
+  /* When a vector fills up, squeeze out the duplicates first and only
+     grow it if that did not free at least half of it.  Switch to a bit
+     vector once that would take less space.  */
+  if (! c->bits && c->num == c->alloc
+      && (c->alloc == 0 || squeeze_conflicts (c) * 2 > c->alloc))
+    {
+      int alloc = c->alloc ? c->alloc * 2 : 8;
+
+      if (alloc * sizeof (int) < allocno_row_words * sizeof (INT_TYPE))
+	{
+	  c->alloc = alloc;
+	  c->vec = (int *) xrealloc (c->vec, alloc * sizeof (int));
+	}
+      else
+	{
+	  int k;
+
+	  c->bits = (INT_TYPE *) obstack_alloc (&global_obstack,
+						allocno_row_words
+						* sizeof (INT_TYPE));
+	  zero_memory ((char *) c->bits,
+		       allocno_row_words * sizeof (INT_TYPE));
+	  for (k = 0; k < c->num; k++)
+	    c->bits[c->vec[k] / INT_BITS]
+	      |= (INT_TYPE) 1 << (c->vec[k] % INT_BITS);
+	  free (c->vec);
+	  c->vec = 0;
+	  c->num = c->alloc = 0;
+	}
     }
+
+  if (c->bits)
+    c->bits[j / INT_BITS] |= (INT_TYPE) 1 << (j % INT_BITS);
+  else
+    c->vec[c->num++] = j;
+}
+
+/* Sort the vector of conflicts C and remove duplicate entries from it.
+   Return the number of entries left.  */
+
+static int
+squeeze_conflicts (c)
+     struct allocno_conflicts *c;
+{
+  register int i, n;
+
+  if (c->num == 0)
+    return 0;
+
+  qsort (c->vec, c->num, sizeof (int), int_compare);
+  for (i = 1, n = 1; i < c->num; i++)
+    if (c->vec[i] != c->vec[n - 1])
+      c->vec[n++] = c->vec[i];
+
+  return c->num = n;
+}
+
+/* Sort predicate for ordering the elements of a conflict vector.  */
+
+static int
+int_compare (v1p, v2p)
+     const void * v1p;
+     const void * v2p;
+{
+  int v1 = *(const int *) v1p, v2 = *(const int *) v2p;
+
+  return v1 < v2 ? -1 : v1 > v2;
+}
+
+/* Once all conflicts have been recorded, make `conflicts' symmetric
+   and put each vector into the canonical form that conflict_p and
+   EXECUTE_IF_CONFLICT expect.  */
+
+static void
+finish_conflicts ()
+{
+  register int i, j;
+
+  /* A conflict recorded in row I also goes in row J.  This may visit
+     conflicts that were themselves added this way, which just makes
+     duplicates for the final squeeze to remove.  */
+  for (i = 0; i < max_allocno; i++)
+    if (conflicts[i].bits)
+      {
+	int word_num;
+
+	for (word_num = 0; word_num < allocno_row_words; word_num++)
+	  {
+	    HOST_WIDE_UINT word = conflicts[i].bits[word_num];
+
+	    for (j = word_num * INT_BITS; word != 0; word >>= 1, j++)
+	      if ((word & 1) && j != i)
+		add_conflict (j, i);
+	  }
+      }
+    else
+      {
+	int n = conflicts[i].num;
+
+	for (j = 0; j < n; j++)
+	  if (conflicts[i].vec[j] != i)
+	    add_conflict (conflicts[i].vec[j], i);
+      }
+
+  for (i = 0; i < max_allocno; i++)
+    if (! conflicts[i].bits)
+      squeeze_conflicts (&conflicts[i]);
+}
+
+/* Return nonzero if allocnos A1 and A2 conflict.  */
+
+static int
+conflict_p (a1, a2)
+     int a1, a2;
+{
+  register struct allocno_conflicts *c = &conflicts[a1];
+  register int lo, hi;
+
+  if (c->bits)
+    return (c->bits[a2 / INT_BITS] & ((INT_TYPE) 1 << (a2 % INT_BITS))) != 0;
+
+  lo = 0;
+  hi = c->num - 1;
+  while (lo <= hi)
+    {
+      int mid = (lo + hi) / 2;
+
+      if (c->vec[mid] == a2)
+	return 1;
+      else if (c->vec[mid] < a2)
+	lo = mid + 1;
+      else
+	hi = mid - 1;
+    }
+
+  return 0;
 }
 
 /* Handle the case where REG is set by the insn being scanned,
@@ -1799,9 +2049,7 @@ dump_conflicts (file)
     {
       register int j;
       fprintf (file, ";; %d conflicts:", allocno_reg[i]);
-      for (j = 0; j < max_allocno; j++)
-	if (CONFLICTP (i, j) || CONFLICTP (j, i))
-	  fprintf (file, " %d", allocno_reg[j]);
+      EXECUTE_IF_CONFLICT (i, j, fprintf (file, " %d", allocno_reg[j]));
       for (j = 0; j < FIRST_PSEUDO_REGISTER; j++)
 	if (TEST_HARD_REG_BIT (hard_reg_conflicts[i], j))
 	  fprintf (file, " %d", j);
@@ -127,6 +127,36 @@ int can_reach_end;
 
 static int cross_jump_death_matters = 0;
 
+/* Hashes of the two insns before a jump, as find_cross_jump walks them
+   with the jump as E1 (stopping at a label) and as E2 (skipping labels).
+   INSN_E1 and INSN_E2 are the insns that were hashed.  KIND is 0 if
+   nothing before the jump can be cross jumped as E1, 1 if only the
+   first insn is known to have to match, and 2 if the first two must.
+   The entry is known to be current while insn_chain_epoch is still
+   EPOCH; after that it is rechecked against EDIT_EPOCH and the insns
+   now before the jump.  */
+
+struct insn_hash
+{
+  unsigned int pattern;
+  unsigned int equiv;
+};
+
+struct tail_hash
+{
+  int epoch;
+  int edit_epoch;
+  int kind;
+  rtx insn_e1[2];
+  rtx insn_e2[2];
+  struct insn_hash as_e1[2];
+  struct insn_hash as_e2[2];
+};
+
+/* Vector indexed by uid, allocated when cross jumping.  */
+
+static struct tail_hash *tail_hash;
+
 static int init_label_info		(rtx);
 static void delete_barrier_successors	(rtx);
 static void mark_all_labels		(rtx, int);
@@ -135,6 +165,13 @@ static void delete_noop_moves		(rtx);
 static int calculate_can_reach_end	(rtx, int, int);
 static int duplicate_loop_exit_test	(rtx);
 static void find_cross_jump		(rtx, rtx, int, rtx *, rtx *);
+static unsigned int hash_renumbered	(rtx);
+static void hash_cross_jump_insn	(rtx, struct insn_hash *);
+static void tail_insns			(rtx, rtx *, rtx *);
+static void hash_tail			(rtx, struct tail_hash *);
+static struct tail_hash *get_tail_hash	(rtx, struct tail_hash *);
+static void free_tail_hash		(void);
+static int tails_may_match		(rtx, rtx);
 static void do_cross_jump		(rtx, rtx, rtx);
 static int jump_back_p			(rtx, rtx);
 static int tension_vector_labels	(rtx, int);
@@ -210,6 +247,13 @@ jump_optimize (f, cross_jump, noop_moves, after_regscan)
   jump_chain = (rtx *) alloca (max_jump_chain * sizeof (rtx));
   zero_memory ((char *) jump_chain, max_jump_chain * sizeof (rtx));
 
+  /* init_emit has bumped insn_chain_epoch past zero, so zeroed
+     entries are stale.  The table is far too big for the stack in
+     large functions.  */
+  if (cross_jump)
+    tail_hash = (struct tail_hash *) xcalloc (max_jump_chain,
+					      sizeof (struct tail_hash));
+
   mark_all_labels (f, cross_jump);
 
   /* Keep track of labels used from static data;
@@ -240,6 +284,7 @@ jump_optimize (f, cross_jump, noop_moves, after_regscan)
 
       /* Show that the jump chain is not valid.  */
       jump_chain = 0;
+      free_tail_hash ();
       return;
     }
 
@@ -1856,6 +1901,7 @@ jump_optimize (f, cross_jump, noop_moves, after_regscan)
 			range2after = NEXT_INSN (range2end);
 
 			/* Splice range2 where range1 was.  */
+			insn_chain_epoch++;
 			NEXT_INSN (range1before) = range2beg;
 			PREV_INSN (range2beg) = range1before;
 			NEXT_INSN (range2end) = range1after;
@@ -1941,6 +1987,8 @@ jump_optimize (f, cross_jump, noop_moves, after_regscan)
 		      SET_SRC (PATTERN (insn))
 			= gen_rtx_LABEL_REF (VOIDmode, JUMP_LABEL (insn));
 		      INSN_CODE (insn) = -1;
+		      insn_chain_epoch++;
+		      insn_edit_epoch++;
 		      emit_barrier_after (insn);
 		      /* Add to jump_chain unless this is a new label
 			 whose UID is too large.  */
@@ -1981,7 +2029,8 @@ jump_optimize (f, cross_jump, noop_moves, after_regscan)
 		      if (target != insn
 			  && JUMP_LABEL (target) == JUMP_LABEL (insn)
 			  /* Ignore TARGET if it's deleted.  */
-			  && ! INSN_DELETED_P (target))
+			  && ! INSN_DELETED_P (target)
+			  && tails_may_match (insn, target))
 			find_cross_jump (insn, target, 2,
 					 &newjpos, &newlpos);
 
@@ -2012,7 +2061,8 @@ jump_optimize (f, cross_jump, noop_moves, after_regscan)
 		       target = jump_chain[INSN_UID (target)])
 		    if (target != insn
 			&& ! INSN_DELETED_P (target)
-			&& GET_CODE (PATTERN (target)) == RETURN)
+			&& GET_CODE (PATTERN (target)) == RETURN
+			&& tails_may_match (insn, target))
 		      find_cross_jump (insn, target, 2,
 				       &newjpos, &newlpos);
 
@@ -2058,6 +2108,7 @@ jump_optimize (f, cross_jump, noop_moves, after_regscan)
 
   /* Show JUMP_CHAIN no longer valid.  */
   jump_chain = 0;
+  free_tail_hash ();
 }
 
 /* Initialize LABEL_NUSES and JUMP_LABEL fields.  Delete any REG_LABEL
@@ -2269,6 +2320,8 @@ delete_noop_moves (f)
 			  PATTERN (insn)
 			    = gen_rtx_USE (VOIDmode, XEXP (trial, 0));
 			  INSN_CODE (insn) = -1;
+			  insn_chain_epoch++;
+			  insn_edit_epoch++;
 			  /* Remove all reg notes but the REG_DEAD one.  */
 			  REG_NOTES (insn) = trial;
 			  XEXP (trial, 1) = NULL_RTX;
@@ -2655,6 +2708,7 @@ squeeze_notes (start, end)
 	  else
 	    {
 	      rtx prev = PREV_INSN (insn);
+	      insn_chain_epoch++;
 	      PREV_INSN (insn) = PREV_INSN (start);
 	      NEXT_INSN (insn) = start;
 	      NEXT_INSN (PREV_INSN (insn)) = insn;
@@ -2832,6 +2886,248 @@ find_cross_jump (e1, e2, minimum, f1, f2)
     *f1 = last1, *f2 = last2;
 }
 
+/* Return a hash of X such that rtx_renumbered_equal_p can only be true
+   of two rtxs that hash alike.  Registers are hashed by mode alone and
+   operands are combined without regard to order, since
+   rtx_renumbered_equal_p looks through renumbering and accepts
+   commuted operands.  */
+
+static unsigned int
+hash_renumbered (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+  unsigned int hash;
+
+  if (code == REG || (code == SUBREG && GET_CODE (SUBREG_REG (x)) == REG))
+    return (unsigned int) REG * 31 + (unsigned int) GET_MODE (x);
+
+  switch (code)
+    {
+    case CONST_INT:
+      return (unsigned int) CONST_INT * 31 + (unsigned int) INTVAL (x);
+
+    case SYMBOL_REF:
+      return (unsigned long) XSTR (x, 0);
+
+    case LABEL_REF:
+    case PC:
+    case CC0:
+    case ADDR_VEC:
+    case ADDR_DIFF_VEC:
+      return (unsigned int) code;
+
+    default:
+      break;
+    }
+
+  hash = (unsigned int) code * 31 + (unsigned int) GET_MODE (x);
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	hash += hash_renumbered (XEXP (x, i));
+      else if (fmt[i] == 'E')
+	{
+	  hash += XVECLEN (x, i);
+	  for (j = XVECLEN (x, i) - 1; j >= 0; j--)
+	    hash += hash_renumbered (XVECEXP (x, i, j));
+	}
+    }
+
+  return hash * 1103515245;
+}
+
+/* Fill in *H for comparison of INSN by find_cross_jump.  EQUIV is
+   the hash of the constant in INSN's REG_EQUAL or REG_EQUIV note, which
+   find_cross_jump may substitute for its source, or zero.  */
+
+static void
+hash_cross_jump_insn (insn, h)
+     rtx insn;
+     struct insn_hash *h;
+{
+  rtx note;
+
+  h->pattern = GET_CODE (insn);
+  if (GET_RTX_CLASS (GET_CODE (insn)) == 'i')
+    h->pattern = h->pattern * 31 + hash_renumbered (PATTERN (insn));
+
+  h->equiv = 0;
+  if (GET_RTX_CLASS (GET_CODE (insn)) == 'i'
+      && ((note = find_reg_note (insn, REG_EQUAL, NULL_RTX)) != 0
+	  || (note = find_reg_note (insn, REG_EQUIV, NULL_RTX)) != 0)
+      && CONSTANT_P (XEXP (note, 0)))
+    {
+      h->equiv = hash_renumbered (XEXP (note, 0));
+      if (h->equiv == 0)
+	h->equiv = 1;
+    }
+}
+
+/* Store in I1 the insns find_cross_jump would look at first with the
+   jump INSN as E1, and in I2 those it would look at with INSN as E2.
+   The walk as E1 stops at a label.  */
+
+static void
+tail_insns (insn, i1, i2)
+     rtx insn;
+     rtx *i1, *i2;
+{
+  rtx p;
+  int n;
+
+  p = insn;
+  for (n = 0; n < 2; n++)
+    {
+      if (p)
+	do
+	  p = PREV_INSN (p);
+	while (p && (GET_CODE (p) == NOTE || GET_CODE (p) == CODE_LABEL));
+      i2[n] = p;
+    }
+
+  i1[0] = prev_nonnote_insn (insn);
+  i1[1] = 0;
+  if (i1[0] != 0 && GET_CODE (i1[0]) != CODE_LABEL)
+    i1[1] = prev_nonnote_insn (i1[0]);
+}
+
+/* Fill in *TH for the jump INSN.  */
+
+static void
+hash_tail (insn, th)
+     rtx insn;
+     struct tail_hash *th;
+{
+  rtx i1;
+  int n;
+
+  tail_insns (insn, th->insn_e1, th->insn_e2);
+
+  /* A missing insn makes the comparison fail, so any hash will do
+     for it.  */
+  for (n = 0; n < 2; n++)
+    if (th->insn_e2[n])
+      hash_cross_jump_insn (th->insn_e2[n], &th->as_e2[n]);
+    else
+      th->as_e2[n].pattern = 1, th->as_e2[n].equiv = 0;
+
+  /* As E1, a label before the first insn means there is nothing to
+     share.  One matching insn is enough if the second is a label or a
+     jump (find_cross_jump lowers its minimum for those) or if either
+     is a USE or CLOBBER, which do not count towards the minimum.  */
+  i1 = th->insn_e1[0];
+  th->kind = 0;
+  if (i1 == 0 || GET_CODE (i1) == CODE_LABEL)
+    return;
+
+  th->kind = 1;
+  hash_cross_jump_insn (i1, &th->as_e1[0]);
+  if (GET_RTX_CLASS (GET_CODE (i1)) != 'i'
+      || GET_CODE (PATTERN (i1)) == USE
+      || GET_CODE (PATTERN (i1)) == CLOBBER)
+    return;
+
+  i1 = th->insn_e1[1];
+  if (i1 == 0
+      || (GET_CODE (i1) != INSN && GET_CODE (i1) != CALL_INSN)
+      || GET_CODE (PATTERN (i1)) == USE
+      || GET_CODE (PATTERN (i1)) == CLOBBER)
+    return;
+
+  th->kind = 2;
+  hash_cross_jump_insn (i1, &th->as_e1[1]);
+}
+
+/* Return the hashes for the jump INSN, computing them unless those
+   remembered for it are still current.  *BUF is used for insns
+   without a slot in tail_hash.  */
+
+static struct tail_hash *
+get_tail_hash (insn, buf)
+     rtx insn;
+     struct tail_hash *buf;
+{
+  int uid = INSN_UID (insn);
+  struct tail_hash *th;
+  rtx i1[2], i2[2];
+
+  if (uid >= max_jump_chain)
+    {
+      hash_tail (insn, buf);
+      return buf;
+    }
+
+  th = &tail_hash[uid];
+  if (th->epoch == insn_chain_epoch)
+    return th;
+
+  /* Insns may have been added, deleted or moved elsewhere, or labels
+     changed; that does not matter if the same insns are still in front
+     of INSN and none has been edited.  */
+  if (th->epoch != 0 && th->edit_epoch == insn_edit_epoch)
+    {
+      tail_insns (insn, i1, i2);
+      if (i1[0] == th->insn_e1[0] && i1[1] == th->insn_e1[1]
+	  && i2[0] == th->insn_e2[0] && i2[1] == th->insn_e2[1])
+	{
+	  th->epoch = insn_chain_epoch;
+	  return th;
+	}
+    }
+
+  hash_tail (insn, th);
+  th->epoch = insn_chain_epoch;
+  th->edit_epoch = insn_edit_epoch;
+  return th;
+}
+
+/* Free the tail hash table if jump_optimize allocated one.  */
+
+static void
+free_tail_hash ()
+{
+  if (tail_hash)
+    {
+      free (tail_hash);
+      tail_hash = 0;
+    }
+}
+
+/* Return zero if find_cross_jump (E1, E2, 2, ...) can neither find
+   common code before the jumps E1 and E2 nor change any insn.  Two
+   insns can only match if their patterns hash alike or if both have
+   equivalent constants that do.  In the latter case find_cross_jump
+   substitutes the constants into both insns whether or not it goes on
+   to find enough common code, so it must be called.  */
+
+static int
+tails_may_match (e1, e2)
+     rtx e1, e2;
+{
+  struct tail_hash buf1, buf2;
+  struct tail_hash *th1 = get_tail_hash (e1, &buf1);
+  struct tail_hash *th2 = get_tail_hash (e2, &buf2);
+  int i;
+
+  if (th1->kind == 0)
+    return 0;
+
+  for (i = 0; i < th1->kind; i++)
+    {
+      if (th1->as_e1[i].equiv != 0
+	  && th1->as_e1[i].equiv == th2->as_e2[i].equiv)
+	return 1;
+      if (th1->as_e1[i].pattern != th2->as_e2[i].pattern)
+	return 0;
+    }
+
+  return 1;
+}
+
 static void
 do_cross_jump (insn, newjpos, newlpos)
      rtx insn, newjpos, newlpos;
@@ -2848,6 +3144,8 @@ do_cross_jump (insn, newjpos, newlpos)
       /* Change the insn.  */
       PATTERN (insn) = gen_jump (label);
       INSN_CODE (insn) = -1;
+      insn_chain_epoch++;
+      insn_edit_epoch++;
       JUMP_LABEL (insn) = label;
       LABEL_NUSES (label)++;
       /* Add to new the jump chain.  */
@@ -3433,6 +3731,7 @@ tension_vector_labels (x, idx)
       if (nlabel && nlabel != olabel)
 	{
 	  XEXP (XVECEXP (x, idx, i), 0) = nlabel;
+	  insn_chain_epoch++;
 	  ++LABEL_NUSES (nlabel);
 	  if (--LABEL_NUSES (olabel) == 0)
 	    delete_insn (olabel);
@@ -3520,7 +3819,11 @@ mark_jump_label (x, insn, cross_jump)
 	      break;
 	  }
 
-	XEXP (x, 0) = label;
+	if (label != olabel)
+	  {
+	    XEXP (x, 0) = label;
+	    insn_chain_epoch++;
+	  }
 	if (! insn || ! INSN_DELETED_P (insn))
 	  ++LABEL_NUSES (label);
 
@@ -3533,7 +3836,10 @@ mark_jump_label (x, insn, cross_jump)
 	       for it, update it as well.  */
 	    else if (label != olabel
 		     && (note = find_reg_note (insn, REG_LABEL, olabel)) != 0)
-	      XEXP (note, 0) = label;
+	      {
+		XEXP (note, 0) = label;
+		insn_chain_epoch++;
+	      }
 
 	    /* Otherwise, add a REG_LABEL note for LABEL unless there already
 	       is one.  */
@@ -3554,6 +3860,8 @@ mark_jump_label (x, insn, cross_jump)
 		   code when it finds a REG_LABEL note.  */
 		REG_NOTES (insn) = gen_rtx_EXPR_LIST (REG_LABEL, label,
 						      REG_NOTES (insn));
+		insn_chain_epoch++;
+		insn_edit_epoch++;
 	      }
 	  }
 	return;
@@ -3640,9 +3948,13 @@ delete_computation (insn)
 	      && !FIND_REG_INC_NOTE (prev, NULL_RTX))
 	    delete_computation (prev);
 	  else
-	    /* Otherwise, show that cc0 won't be used.  */
-	    REG_NOTES (prev) = gen_rtx_EXPR_LIST (REG_UNUSED,
-						  cc0_rtx, REG_NOTES (prev));
+	    {
+	      /* Otherwise, show that cc0 won't be used.  */
+	      REG_NOTES (prev) = gen_rtx_EXPR_LIST (REG_UNUSED,
+						    cc0_rtx, REG_NOTES (prev));
+	      insn_chain_epoch++;
+	      insn_edit_epoch++;
+	    }
 	}
     }
 #endif
@@ -3715,6 +4027,8 @@ delete_computation (insn)
 	    {
 	      XEXP (note, 1) = REG_NOTES (our_prev);
 	      REG_NOTES (our_prev) = note;
+	      insn_chain_epoch++;
+	      insn_edit_epoch++;
 	      break;
 	    }
 	}
@@ -3745,6 +4059,8 @@ delete_insn (insn)
   if (INSN_DELETED_P (insn))
     return next;
 
+  insn_chain_epoch++;
+
   /* Don't delete user-declared labels.  Convert them to special NOTEs
      instead.  */
   if (was_code_label && LABEL_NAME (insn) != 0
@@ -3905,6 +4221,7 @@ delete_for_peephole (from, to)
       if (GET_CODE (insn) != NOTE)
 	{
 	  INSN_DELETED_P (insn) = 1;
+	  insn_chain_epoch++;
 
 	  /* Patch this insn out of the chain.  */
 	  /* We don't do this all at once, because we
@@ -4123,7 +4440,10 @@ redirect_exp (loc, olabel, nlabel, insn)
       if (XEXP (x, 0) == olabel)
 	{
 	  if (nlabel)
-	    XEXP (x, 0) = nlabel;
+	    {
+	      XEXP (x, 0) = nlabel;
+	      insn_chain_epoch++;
+	    }
 	  else
 	    return validate_change (insn, loc, gen_rtx_RETURN (VOIDmode), 0);
 	  return 1;
@@ -4185,6 +4505,8 @@ redirect_tablejump (jump, nlabel)
   JUMP_LABEL (jump) = nlabel;
   ++LABEL_NUSES (nlabel);
   INSN_CODE (jump) = -1;
+  insn_chain_epoch++;
+  insn_edit_epoch++;
 
   if (--LABEL_NUSES (olabel) == 0)
     {
@@ -5183,6 +5505,8 @@ conditional_execution (insn)
       cexec *ce = &fix_insns[i];
       PATTERN (ce->insn) = ce->new_pattern;
       INSN_CODE (ce->insn) = ce->recog_code;
+      insn_chain_epoch++;
+      insn_edit_epoch++;
     }
 
   return ret;
@@ -5243,6 +5567,8 @@ branch_predict_move (insn, cur_line, barrier, barrier_end)
 #endif
 
   /* Make the label next after this branch.  */
+  insn_chain_epoch++;
+  insn_edit_epoch++;
   NEXT_INSN (insn) = label;
   PREV_INSN (label) = insn;
   LABEL_NUSES (label)--;
@@ -211,16 +211,31 @@ short *reg_renumber;
 static HARD_REG_SET regs_live;
 
 /* Each set of hard registers indicates registers live at a particular
-   point in the basic block.  For N even, regs_live_at[N] says which
+   point in the basic block.  For N even, the set at index N says which
    hard registers are needed *after* insn N/2 (i.e., they may not
    conflict with the outputs of insn N/2 or the inputs of insn N/2 + 1.
 
    If an object is to conflict with the inputs of insn J but not the
    outputs of insn J + 1, we say it is born at index J*2 - 1.  Similarly,
    if it is to conflict with the outputs of insn J but not the inputs of
-   insn J + 1, it is said to die at index J*2 + 1.  */
+   insn J + 1, it is said to die at index J*2 + 1.
 
-static HARD_REG_SET *regs_live_at;
+   Lifetimes are only ever added to these sets, and find_free_reg asks
+   for the union of the sets over a lifetime, so they are kept in a
+   segment tree rather than one per index; both operations then take
+   time logarithmic in the length of the block.  The set at index N is
+   leaf live_at_base + N, node 1 is the root and the children of node
+   M are 2M and 2M+1.  live_at_all[M] holds the registers recorded as
+   live at every index below M and live_at_any[M] those recorded as
+   live at some index below it.
+
+   While block_alloc scans the insns only the leaves are written;
+   live_at_built is set once the rest of the tree has been filled in.  */
+
+static HARD_REG_SET *live_at_all;
+static HARD_REG_SET *live_at_any;
+static int live_at_base;
+static int live_at_built;
 
 /* Communicate local vars `insn_number' and `insn'
    from `block_alloc' to `reg_is_set', `wipe_dead_reg', and `alloc_qty'.  */
@@ -259,7 +274,9 @@ static void wipe_dead_reg	(rtx, int);
 static int find_free_reg	(enum reg_class, enum machine_mode,
 				       int, int, int, int, int);
 static void mark_life		(int, enum machine_mode, int);
-static void post_mark_life	(int, enum machine_mode, int, int, int);
+static void post_mark_life	(int, enum machine_mode, int, int);
+static void mark_live_at	(int, int, HARD_REG_SET *);
+static void live_at_between	(int, int, HARD_REG_SET *);
 static int no_conflict_p	(rtx, rtx, rtx);
 static int requires_inout	(char *);
 
@@ -1033,9 +1050,14 @@ block_alloc (b)
 
   /* +2 to leave room for a post_mark_life at the last insn and for
      the birth of a CLOBBER in the first insn.  */
-  regs_live_at = (HARD_REG_SET *) alloca ((2 * insn_count + 2)
-					  * sizeof (HARD_REG_SET));
-  zero_memory ((char *) regs_live_at, (2 * insn_count + 2) * sizeof (HARD_REG_SET));
+  for (live_at_base = 1; live_at_base < 2 * insn_count + 2; )
+    live_at_base *= 2;
+
+  live_at_all = (HARD_REG_SET *) xcalloc (2 * live_at_base,
+					  sizeof (HARD_REG_SET));
+  live_at_any = (HARD_REG_SET *) xcalloc (2 * live_at_base,
+					  sizeof (HARD_REG_SET));
+  live_at_built = 0;
 
   /* Initialize table of hardware registers currently live.  */
 
@@ -1280,8 +1302,7 @@ block_alloc (b)
 	 record the registers live before the block's first insn, since no
 	 pseudos we care about are live before that insn.  */
 
-      IOR_HARD_REG_SET (regs_live_at[2 * insn_number], regs_live);
-      IOR_HARD_REG_SET (regs_live_at[2 * insn_number + 1], regs_live);
+      mark_live_at (2 * insn_number, 2 * insn_number + 2, &regs_live);
 
       if (insn == BLOCK_END (b))
 	break;
@@ -1289,6 +1310,15 @@ block_alloc (b)
       insn = NEXT_INSN (insn);
     }
 
+  /* Fill in the rest of the tree of live registers from its leaves.  */
+
+  for (i = live_at_base - 1; i > 0; i--)
+    {
+      COPY_HARD_REG_SET (live_at_any[i], live_at_any[2 * i]);
+      IOR_HARD_REG_SET (live_at_any[i], live_at_any[2 * i + 1]);
+    }
+  live_at_built = 1;
+
   /* Now every register that is local to this basic block
      should have been given a quantity, or else -1 meaning ignore it.
      Every quantity should have a known birth and death.  
@@ -1414,6 +1444,9 @@ block_alloc (b)
 	for (i = qty_first_reg[q]; i >= 0; i = reg_next_in_qty[i])
 	  reg_renumber[i] = qty_phys_reg[q] + reg_offset[i];
       }
+
+  free (live_at_all);
+  free (live_at_any);
 }
 
 /* Compare two quantities' priority for getting real registers.
@@ -1779,7 +1812,7 @@ reg_is_born (reg, birth)
       /* If the register was to have been born earlier that the present
 	 insn, mark it as live where it is actually born.  */
       if (birth < 2 * this_insn_number)
-	post_mark_life (regno, GET_MODE (reg), 1, birth, 2 * this_insn_number);
+	post_mark_life (regno, GET_MODE (reg), birth, 2 * this_insn_number);
     }
   else
     {
@@ -1844,7 +1877,7 @@ wipe_dead_reg (reg, output_p)
 	 the beginning of this insn (the above statement would cause this
 	 not to happen).  */
       if (output_p)
-	post_mark_life (regno, GET_MODE (reg), 1,
+	post_mark_life (regno, GET_MODE (reg),
 			2 * this_insn_number, 2 * this_insn_number+ 1);
     }
 
@@ -1874,11 +1907,12 @@ find_free_reg (class, mode, qty, accept_call_clobbered, just_try_suggested,
      int just_try_suggested;
      int born_index, dead_index;
 {
-  register int i, ins;
+  register int i;
 #ifdef HARD_REG_SET
   register		/* Declare it register if it's a scalar.  */
 #endif
     HARD_REG_SET used, first_used;
+  HARD_REG_SET live;
 #ifdef ELIMINABLE_REGS
   static struct {int from, to; } eliminables[] = ELIMINABLE_REGS;
 #endif
@@ -1903,8 +1937,9 @@ find_free_reg (class, mode, qty, accept_call_clobbered, just_try_suggested,
   if (accept_call_clobbered)
     IOR_HARD_REG_SET (used, losing_caller_save_reg_set);
 
-  for (ins = born_index; ins < dead_index; ins++)
-    IOR_HARD_REG_SET (used, regs_live_at[ins]);
+  CLEAR_HARD_REG_SET (live);
+  live_at_between (born_index, dead_index, &live);
+  IOR_HARD_REG_SET (used, live);
 
   IOR_COMPL_HARD_REG_SET (used, reg_class_contents[(int) class]);
 
@@ -1960,7 +1995,7 @@ find_free_reg (class, mode, qty, accept_call_clobbered, just_try_suggested,
 	    {
 	      /* Mark that this register is in use between its birth and death
 		 insns.  */
-	      post_mark_life (regno, mode, 1, born_index, dead_index);
+	      post_mark_life (regno, mode, born_index, dead_index);
 	      return regno;
 	    }
 	  i += j;		/* Skip starting points we know will lose */
@@ -2021,40 +2056,101 @@ mark_life (regno, mode, life)
       CLEAR_HARD_REG_BIT (regs_live, regno + j);
 }
 
-/* Mark register number REGNO (with machine-mode MODE) as live (if LIFE
-   is non-zero) or dead (if LIFE is zero) from insn number BIRTH (inclusive)
-   to insn number DEATH (exclusive).  */
+/* Mark register number REGNO (with machine-mode MODE) as live from insn
+   number BIRTH (inclusive) to insn number DEATH (exclusive).  */
 
 static void
-post_mark_life (regno, mode, life, birth, death)
+post_mark_life (regno, mode, birth, death)
      int regno;
      enum machine_mode mode;
-     int life, birth, death;
+     int birth, death;
 {
   register int j = HARD_REGNO_NREGS (regno, mode);
-#ifdef HARD_REG_SET
-  register		/* Declare it register if it's a scalar.  */
-#endif
-    HARD_REG_SET this_reg;
+  HARD_REG_SET this_reg;
 
   CLEAR_HARD_REG_SET (this_reg);
   while (--j >= 0)
     SET_HARD_REG_BIT (this_reg, regno + j);
 
-  if (life)
-    while (birth < death)
-      {
-	IOR_HARD_REG_SET (regs_live_at[birth], this_reg);
-	birth++;
-      }
-  else
-    while (birth < death)
-      {
-	AND_COMPL_HARD_REG_SET (regs_live_at[birth], this_reg);
-	birth++;
-      }
+  mark_live_at (birth, death, &this_reg);
 }
 
+/* Record the registers in *SET as live from index FROM (inclusive) to
+   index TO (exclusive).  */
+
+static void
+mark_live_at (from, to, set)
+     int from, to;
+     HARD_REG_SET *set;
+{
+  int lo = live_at_base + from;
+  int hi = live_at_base + to;
+  int n;
+
+  if (from >= to)
+    return;
+
+  if (! live_at_built)
+    {
+      for (n = lo; n < hi; n++)
+	IOR_HARD_REG_SET (live_at_any[n], *set);
+      return;
+    }
+
+  /* Every node above either end of the range has some index in it.  */
+  for (n = lo >> 1; n > 0; n >>= 1)
+    IOR_HARD_REG_SET (live_at_any[n], *set);
+  for (n = (hi - 1) >> 1; n > 0; n >>= 1)
+    IOR_HARD_REG_SET (live_at_any[n], *set);
+
+  for (; lo < hi; lo >>= 1, hi >>= 1)
+    {
+      if (lo & 1)
+	{
+	  IOR_HARD_REG_SET (live_at_all[lo], *set);
+	  IOR_HARD_REG_SET (live_at_any[lo], *set);
+	  lo++;
+	}
+      if (hi & 1)
+	{
+	  hi--;
+	  IOR_HARD_REG_SET (live_at_all[hi], *set);
+	  IOR_HARD_REG_SET (live_at_any[hi], *set);
+	}
+    }
+}
+
+/* Add to *SET the registers live at any index from FROM (inclusive) to
+   TO (exclusive).  */
+
+static void
+live_at_between (from, to, set)
+     int from, to;
+     HARD_REG_SET *set;
+{
+  int lo = live_at_base + from;
+  int hi = live_at_base + to;
+  int n;
+
+  if (from >= to)
+    return;
+
+  /* Registers live throughout a node above either end of the range
+     are live within the range.  */
+  for (n = lo >> 1; n > 0; n >>= 1)
+    IOR_HARD_REG_SET (*set, live_at_all[n]);
+  for (n = (hi - 1) >> 1; n > 0; n >>= 1)
+    IOR_HARD_REG_SET (*set, live_at_all[n]);
+
+  for (; lo < hi; lo >>= 1, hi >>= 1)
+    {
+      if (lo & 1)
+	IOR_HARD_REG_SET (*set, live_at_any[lo++]);
+      if (hi & 1)
+	IOR_HARD_REG_SET (*set, live_at_any[--hi]);
+    }
+}
+
 /* INSN is the CLOBBER insn that starts a REG_NO_NOCONFLICT block, R0
    is the register being clobbered, and R1 is a register being used in
    the equivalent expression.
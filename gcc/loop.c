@@ -69,6 +69,38 @@ int max_uid_for_loop;
 
 static int max_luid;
 
+/* Index used by loop_reg_used_before_p for the loop being scanned.
+   Indexed by INSN_UID, the position at which loop_reg_used_before_p
+   reaches the insn when it scans from the loop entry; indexed by
+   register number, the position of the first insn that mentions the
+   register.  Positions are taken from a counter that runs on across
+   loops, so any entry not above scan_pos_base is from an earlier
+   loop and means the insn was not reached or the register not
+   mentioned.  */
+
+static int *insn_scan_pos;
+static int *reg_first_use_pos;
+static int scan_pos_base;
+static int scan_pos_last;
+
+/* Nonzero if the index is up to date for the current loop.  */
+
+static int scan_pos_valid;
+
+/* Number of queries answered by scanning since the index was last
+   invalidated.  Building the index costs a pass over the whole loop,
+   so it is only done once a loop has been asked about repeatedly.  */
+
+static int scan_pos_queries;
+
+#define SCAN_POS_MIN_QUERIES 8
+
+/* The index only answers for pseudos from this number up.  Below it,
+   a pattern can mention a register without containing it (see
+   refers_to_regno_p).  */
+
+static int scan_pos_unsafe_regno;
+
 /* Number of loops detected in current function.  Used as index to the
    next few tables.  */
 
@@ -293,6 +325,8 @@ static void count_one_set (rtx, rtx, varray_type, rtx *);
 static void count_loop_regs_set (rtx, rtx, varray_type, varray_type,
 				       int *, int); 
 static void note_addr_stored (rtx, rtx);
+static int note_first_use (rtx *, void *);
+static void index_reg_uses (rtx, rtx, rtx);
 static int loop_reg_used_before_p (rtx, rtx, rtx, rtx, rtx);
 static void scan_loop (rtx, rtx, rtx, int, int);
 #if 0
@@ -496,6 +530,12 @@ loop_optimize (f, dumpfile, unroll_p, bct_p)
   zero_memory ((char *) uid_luid, max_uid_for_loop * sizeof (int));
   zero_memory ((char *) uid_loop_num, max_uid_for_loop * sizeof (int));
 
+  insn_scan_pos = (int *) alloca (max_uid_for_loop * sizeof (int));
+  reg_first_use_pos = (int *) alloca (max_reg_before_loop * sizeof (int));
+  zero_memory ((char *) insn_scan_pos, max_uid_for_loop * sizeof (int));
+  zero_memory ((char *) reg_first_use_pos, max_reg_before_loop * sizeof (int));
+  scan_pos_last = 0;
+
   /* Allocate tables for recording each loop.  We set each entry, so they need
      not be zeroed.  */
   loop_number_loop_starts = (rtx *) alloca (max_loop_num * sizeof (rtx));
@@ -576,6 +616,11 @@ loop_optimize (f, dumpfile, unroll_p, bct_p)
   if (unroll_p && write_symbols != NO_DEBUG)
     unroll_block_trees ();
 
+  /* Loop rewrites insns and register lifetimes in place; make sure
+     nothing that ran before it is considered current.  */
+  insn_chain_epoch++;
+  insn_edit_epoch++;
+
   end_alias_analysis ();
 }
 
@@ -694,6 +739,8 @@ scan_loop (loop_start, end, loop_cont, unroll_p, bct_p)
 
   /* Set up variables describing this loop.  */
   prescan_loop (loop_start, end);
+  scan_pos_valid = 0;
+  scan_pos_queries = 0;
   threshold = (loop_has_call ? 1 : 2) * (1 + n_non_fixed_regs);
 
   /* If loop has a jump before the first label,
@@ -937,6 +984,8 @@ scan_loop (loop_start, end, loop_cont, unroll_p, bct_p)
 		  NOTE_LINE_NUMBER (p) = NOTE_INSN_DELETED;
 		  NOTE_SOURCE_FILE (p) = 0;
 		  VARRAY_INT (set_in_loop, regno) = 0;
+		  scan_pos_valid = 0;
+		  scan_pos_queries = 0;
 		  continue;
 		}
 
@@ -3548,6 +3597,84 @@ count_loop_regs_set (from, to, may_not_move, single_usage, count_ptr, nregs)
    that have a valid INSN_LUID, it means we cannot move an invariant out
    from an inner loop past two loops.  */
 
+/* Called via for_each_rtx on each part of the pattern PDATA of the
+   insn at position scan_pos_last.  Record that position for any
+   register the pattern mentions that has no position yet.  */
+
+static int
+note_first_use (x, pdata)
+     rtx *x;
+     void *pdata;
+{
+  rtx pattern = (rtx) pdata;
+  int regno, end;
+
+  if (*x == 0)
+    return 0;
+
+  if (GET_CODE (*x) == SUBREG && GET_CODE (SUBREG_REG (*x)) == REG
+      && REGNO (SUBREG_REG (*x)) < FIRST_PSEUDO_REGISTER)
+    {
+      /* No register takes up less than a byte.  */
+      end = (REGNO (SUBREG_REG (*x)) + SUBREG_WORD (*x)
+	     + GET_MODE_SIZE (GET_MODE (*x)));
+      if (end > scan_pos_unsafe_regno)
+	scan_pos_unsafe_regno = end;
+      return 0;
+    }
+
+  if (GET_CODE (*x) != REG)
+    return 0;
+
+  regno = REGNO (*x);
+  if (regno < FIRST_PSEUDO_REGISTER)
+    {
+      end = regno + HARD_REGNO_NREGS (regno, GET_MODE (*x));
+      if (regno == STACK_POINTER_REGNUM || regno == ARG_POINTER_REGNUM
+	  || regno == FRAME_POINTER_REGNUM)
+	end = MAX (end, LAST_VIRTUAL_REGISTER + 1);
+      if (end > scan_pos_unsafe_regno)
+	scan_pos_unsafe_regno = end;
+    }
+  else if (regno < max_reg_before_loop
+	   && reg_first_use_pos[regno] <= scan_pos_base
+	   && reg_overlap_mentioned_p (*x, pattern))
+    reg_first_use_pos[regno] = scan_pos_last;
+
+  return 0;
+}
+
+/* Fill in the index used by loop_reg_used_before_p for the loop bounded
+   by LOOP_START and LOOP_END and entered at SCAN_START.  */
+
+static void
+index_reg_uses (loop_start, scan_start, loop_end)
+     rtx loop_start, scan_start, loop_end;
+{
+  rtx p;
+
+  scan_pos_base = scan_pos_last;
+  scan_pos_unsafe_regno = FIRST_PSEUDO_REGISTER;
+
+  p = scan_start;
+  do
+    {
+      scan_pos_last++;
+      if (INSN_UID (p) < max_uid_for_loop)
+	insn_scan_pos[INSN_UID (p)] = scan_pos_last;
+
+      if (GET_RTX_CLASS (GET_CODE (p)) == 'i')
+	for_each_rtx (&PATTERN (p), note_first_use, PATTERN (p));
+
+      if (p == loop_end)
+	p = loop_start;
+      p = NEXT_INSN (p);
+    }
+  while (p != 0 && p != scan_start);
+
+  scan_pos_valid = 1;
+}
+
 static int
 loop_reg_used_before_p (set, insn, loop_start, scan_start, loop_end)
      rtx set, insn, loop_start, scan_start, loop_end;
@@ -3555,6 +3682,25 @@ loop_reg_used_before_p (set, insn, loop_start, scan_start, loop_end)
   rtx reg = SET_DEST (set);
   rtx p;
 
+  /* Once a loop has been asked about often enough, answer most
+     registers from the index, which makes one pass over the loop
+     rather than one for each insn asked about.  */
+  if (GET_CODE (reg) == REG
+      && (scan_pos_valid || ++scan_pos_queries > SCAN_POS_MIN_QUERIES))
+    {
+      int regno = REGNO (reg);
+
+      if (! scan_pos_valid)
+	index_reg_uses (loop_start, scan_start, loop_end);
+
+      if (regno >= scan_pos_unsafe_regno
+	  && regno < max_reg_before_loop
+	  && INSN_UID (insn) < max_uid_for_loop
+	  && insn_scan_pos[INSN_UID (insn)] > scan_pos_base)
+	return (reg_first_use_pos[regno] > scan_pos_base
+		&& reg_first_use_pos[regno] < insn_scan_pos[INSN_UID (insn)]);
+    }
+
   /* Scan forward checking for register usage.  If we hit INSN, we
      are done.  Otherwise, if we hit LOOP_END, wrap around to LOOP_START.  */
   for (p = scan_start; p != insn; p = NEXT_INSN (p))
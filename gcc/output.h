@@ -104,6 +104,13 @@ extern void output_address	(rtx);
    that may appear in these expressions.  */
 extern void output_addr_const (FILE *, rtx);
 
+/* The most characters sprint_wint can store.  */
+#define MAX_WINT_CHARS 12
+
+/* Store the text output_addr_const writes for an integer in a buffer
+   and return its length.  */
+extern int sprint_wint (char *, HOST_WIDE_INT);
+
 /* Output a string of assembler code, substituting numbers, strings
    and fixed syntactic prefixes.  */
 extern void asm_fprintf		(FILE *file, char *p, ...);
@@ -308,6 +315,10 @@ extern void output_constant_pool	(char *, tree);
 extern void output_constant		(tree, int);
 #endif
 
+/* Output the run of integer constants that output_constant has
+   collected for -fpack-data, if any.  */
+extern void output_data_run		(void);
+
 /* When outputting assembler code, indicates which alternative
    of the constraints was actually satisfied.  */
 extern int which_alternative;
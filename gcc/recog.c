@@ -229,6 +229,8 @@ validate_change (object, loc, new, in_group)
     abort ();
 
   *loc = new;
+  insn_chain_epoch++;
+  insn_edit_epoch++;
 
   /* Save the information describing this change.  */
   if (num_changes >= changes_allocated)
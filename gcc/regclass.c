@@ -637,6 +637,28 @@ static struct costs init_cost;
 
 static struct costs op_costs[MAX_RECOG_OPERANDS];
 
+/* The costs that record_reg_classes computes for an insn depend only on
+   its insn code and on the shape of each operand: its rtx code and modes,
+   which operands are equal, the register number of a hard reg, the value
+   of a CONST_INT, the code of a MEM's address and, for a pseudo, its
+   tentative class and whether it dies.  Insns of the same shape recur
+   constantly, so we remember the resulting op_costs keyed on that shape.
+
+   Each key is OP_COST_KEY_WORDS (N) words: the insn code, the number of
+   operands and whether prefclass is in use, then two words per operand.  */
+
+#define OP_COST_CACHE_SIZE 251
+#define OP_COST_CACHE_OPS 4
+#define OP_COST_KEY_WORDS(N) (3 + 2 * (N))
+
+struct op_cost_entry
+{
+  HOST_WIDE_INT key[OP_COST_KEY_WORDS (OP_COST_CACHE_OPS)];
+  struct costs costs[OP_COST_CACHE_OPS];
+};
+
+static struct op_cost_entry *op_cost_cache;
+
 /* (enum reg_class) prefclass[R] is the preferred class for pseudo number R.
    This is available after `regclass' is run.  */
 
@@ -670,6 +692,10 @@ static int loop_cost;
 static rtx scan_one_insn	(rtx, int);
 static void record_reg_classes	(int, int, rtx *, enum machine_mode *,
 				       char **, rtx);
+static void record_copy_classes	(rtx *, rtx);
+static int op_cost_key		(rtx, int, rtx *, enum machine_mode *,
+				       HOST_WIDE_INT *);
+static unsigned int op_cost_hash (HOST_WIDE_INT *, int);
 static int copy_cost		(rtx, enum machine_mode, 
 				       enum reg_class, int);
 static void record_address_regs	(rtx, enum reg_class, int);
@@ -733,8 +759,10 @@ scan_one_insn (insn, pass)
   enum rtx_code pat_code;
   char *constraints[MAX_RECOG_OPERANDS];
   enum machine_mode modes[MAX_RECOG_OPERANDS];
+  HOST_WIDE_INT key[OP_COST_KEY_WORDS (OP_COST_CACHE_OPS)];
+  struct op_cost_entry *entry;
   rtx set, note;
-  int i, j;
+  int i, j, n_key;
 
   /* Show that an insn inside a loop is likely to be executed three
      times more than insns outside a loop.  This is much more aggressive
@@ -867,11 +895,27 @@ scan_one_insn (insn, pass)
 			     BASE_REG_CLASS, loop_cost * 2);
     }
 
+  /* See whether an insn of the same shape has been costed already.  */
+
+  n_key = op_cost_key (insn, recog_n_operands, recog_operand, modes, key);
+  entry = 0;
+  if (n_key != 0)
+    {
+      entry = &op_cost_cache[op_cost_hash (key, n_key)];
+      if (! memcmp (entry->key, key, n_key * sizeof key[0]))
+	{
+	  memcpy (op_costs, entry->costs,
+		  recog_n_operands * sizeof op_costs[0]);
+	  entry = 0;
+	  n_key = -1;
+	}
+    }
+
   /* Check for commutative in a separate loop so everything will
      have been initialized.  We must do this even if one operand
      is a constant--see addsi3 in m68k.md.  */
 
-  for (i = 0; i < recog_n_operands - 1; i++)
+  for (i = 0; n_key >= 0 && i < recog_n_operands - 1; i++)
     if (constraints[i][0] == '%')
       {
 	char *xconstraints[MAX_RECOG_OPERANDS];
@@ -890,8 +934,18 @@ scan_one_insn (insn, pass)
 			    insn);
       }
 
-  record_reg_classes (recog_n_alternatives, recog_n_operands, recog_operand,
-		      modes, constraints, insn);
+  if (n_key >= 0)
+    record_reg_classes (recog_n_alternatives, recog_n_operands, recog_operand,
+			modes, constraints, insn);
+
+  if (entry != 0)
+    {
+      memcpy (entry->key, key, n_key * sizeof key[0]);
+      memcpy (entry->costs, op_costs,
+	      recog_n_operands * sizeof op_costs[0]);
+    }
+
+  record_copy_classes (recog_operand, insn);
 
   /* Now add the cost for each operand to the total costs for
      its register.  */
@@ -930,6 +984,10 @@ regclass (f, nregs)
 
   costs = (struct costs *) xmalloc (nregs * sizeof (struct costs));
 
+  if (op_cost_cache == 0)
+    op_cost_cache = (struct op_cost_entry *)
+      xcalloc (OP_COST_CACHE_SIZE, sizeof (struct op_cost_entry));
+
 #ifdef FORBIDDEN_INC_DEC_CLASSES
 
   in_inc_dec = (char *) alloca (nregs);
@@ -1117,7 +1175,6 @@ record_reg_classes (n_alts, n_ops, ops, modes, constraints, insn)
 {
   int alt;
   int i, j;
-  rtx set;
 
   /* Process each alternative, each time minimizing an operand's cost with
      the cost for each operand in that alternative.  */
@@ -1440,10 +1497,22 @@ record_reg_classes (n_alts, n_ops, ops, modes, constraints, insn)
 				     (qq->cost[class] + alt_cost) * scale);
 	  }
     }
+}
 
-  /* If this insn is a single set copying operand 1 to operand 0
-     and one is a pseudo with the other a hard reg that is in its
-     own register class, set the cost of that register class to -1.  */
+/* If INSN is a single set copying operand 1 to operand 0 and one is a
+   pseudo with the other a hard reg that is in its own register class,
+   set the cost of that register class to -1.  OPS is the array of
+   operands.  This is done after the alternatives have been costed;
+   since those costs are never negative, the result is the same as if
+   it were done after each call to record_reg_classes.  */
+
+static void
+record_copy_classes (ops, insn)
+     rtx *ops;
+     rtx insn;
+{
+  rtx set;
+  int i;
 
   if ((set = single_set (insn)) != 0
       && ops[0] == SET_DEST (set) && ops[1] == SET_SRC (set)
@@ -1482,6 +1551,85 @@ record_reg_classes (n_alts, n_ops, ops, modes, constraints, insn)
 	}
 }
 
+/* Store in KEY the shape of INSN as record_reg_classes sees it, for
+   looking up its costs in op_cost_cache.  N_OPS, OPS and MODES are as
+   for record_reg_classes.  Return the number of words used, or zero if
+   the costs of INSN should not be cached.
+
+   We assume, as holds for Thumb, that EXTRA_CONSTRAINT and the reload
+   class macros look no further into a MEM than the code of its address.  */
+
+static int
+op_cost_key (insn, n_ops, ops, modes, key)
+     rtx insn;
+     int n_ops;
+     rtx *ops;
+     enum machine_mode *modes;
+     HOST_WIDE_INT *key;
+{
+  int i, j;
+
+  if (INSN_CODE (insn) < 0 || n_ops > OP_COST_CACHE_OPS)
+    return 0;
+
+  key[0] = INSN_CODE (insn) + 1;
+  key[1] = n_ops;
+  key[2] = prefclass != 0;
+
+  for (i = 0; i < n_ops; i++)
+    {
+      rtx op = ops[i];
+      enum rtx_code code = GET_CODE (op);
+      int pseudo_p = code == REG && REGNO (op) >= FIRST_PSEUDO_REGISTER;
+      HOST_WIDE_INT datum = 0;
+
+      /* Find the first operand that a matching constraint would consider
+	 the same as this one.  */
+      for (j = 0; j < i; j++)
+	if (pseudo_p
+	    ? GET_CODE (ops[j]) == REG && REGNO (ops[j]) == REGNO (op)
+	    : rtx_equal_p (ops[j], op))
+	  break;
+
+      if (pseudo_p)
+	datum = ((prefclass ? prefclass[REGNO (op)] : 0) << 1
+		 | (find_reg_note (insn, REG_DEAD, op) != 0));
+      else if (code == REG)
+	datum = REGNO (op);
+      else if (code == CONST_INT)
+	datum = INTVAL (op);
+      else if (code == MEM)
+	datum = GET_CODE (XEXP (op, 0));
+      else if (code == CONST_DOUBLE)
+	return 0;
+
+      key[3 + 2 * i] = ((HOST_WIDE_INT) code
+			| (HOST_WIDE_INT) GET_MODE (op) << 8
+			| (HOST_WIDE_INT) modes[i] << 16
+			| (HOST_WIDE_INT) j << 24
+			| (HOST_WIDE_INT) pseudo_p << 28);
+      key[4 + 2 * i] = datum;
+    }
+
+  return OP_COST_KEY_WORDS (n_ops);
+}
+
+/* Return the slot in op_cost_cache for the N-word KEY.  */
+
+static unsigned int
+op_cost_hash (key, n)
+     HOST_WIDE_INT *key;
+     int n;
+{
+  unsigned int hash = 0;
+  int i;
+
+  for (i = 0; i < n; i++)
+    hash = hash * 1000003 + (unsigned int) key[i];
+
+  return (hash ^ (hash >> 29)) % OP_COST_CACHE_SIZE;
+}
+
 /* Compute the cost of loading X into (if TO_P is non-zero) or from (if
    TO_P is zero) a register of class CLASS in mode MODE.
 
@@ -1752,6 +1900,14 @@ auto_inc_dec_reg_p (reg, mode)
 static short *renumber = (short *)0;
 static size_t regno_allocated = 0;
 
+/* The value of insn_chain_epoch when reg_scan last finished, and the
+   NREGS it was given.  If neither has changed and nothing else has
+   touched the register info since, a rescan would recompute exactly
+   what is already there.  -1 when the info can not be trusted.  */
+
+static int reg_scan_epoch = -1;
+static int reg_scan_nregs;
+
 /* Allocate enough space to hold NUM_REGS registers for the tables used for
    reg_scan and flow_analysis that are indexed by the register number.  If
    NEW_P is non zero, initialize all of the registers, otherwise only
@@ -1771,6 +1927,8 @@ allocate_reg_info (num_regs, new_p, renumber_p)
   struct reg_info_data *reg_data;
   struct reg_info_data *reg_next;
 
+  reg_scan_epoch = -1;
+
   if (num_regs > regno_allocated)
     {
       size_t old_allocated = regno_allocated;
@@ -1876,6 +2034,7 @@ allocate_reg_info (num_regs, new_p, renumber_p)
 void
 free_reg_info ()
 {
+  reg_scan_epoch = -1;
   if (reg_n_info)
     {
       struct reg_info_data *reg_data;
@@ -1906,7 +2065,9 @@ free_reg_info ()
    and records them in the vectors regno_first_uid, regno_last_uid
    and counts the number of sets in the vector reg_n_sets.
 
-   REPEAT is nonzero the second time this is called.  */
+   REPEAT is nonzero the second time this is called.
+
+   Nothing is done if the insns have not changed since the last scan.  */
 
 /* Maximum number of parallel sets and clobbers in any insn in this fn.
    Always at least 3, since the combiner could put that many together
@@ -1922,6 +2083,9 @@ reg_scan (f, nregs, repeat)
 {
   register rtx insn;
 
+  if (reg_scan_epoch == insn_chain_epoch && reg_scan_nregs == nregs)
+    return;
+
   allocate_reg_info (nregs, TRUE, FALSE);
   max_parallel = 3;
 
@@ -1938,6 +2102,9 @@ reg_scan (f, nregs, repeat)
 	if (REG_NOTES (insn))
 	  reg_scan_mark_refs (REG_NOTES (insn), insn, 1, 0);
       }
+
+  reg_scan_epoch = insn_chain_epoch;
+  reg_scan_nregs = nregs;
 }
 
 /* Update 'regscan' information by looking at the insns
@@ -47,6 +47,12 @@ static void optimize_reg_copy_2	(rtx, rtx, rtx);
 static void optimize_reg_copy_3	(rtx, rtx, rtx);
 static rtx gen_add3_insn	(rtx, rtx, rtx);
 static void copy_src_to_dest	(rtx, rtx, rtx, int, int);
+static int note_pseudo_ref	(rtx *, void *);
+static void index_pseudo_refs	(void);
+static void free_pseudo_refs	(void);
+static int refs_after		(int *, int, int);
+static int refs_near		(int, int, int);
+static rtx skip_unrelated_insns	(rtx, int, int, int, int *);
 static int *regmove_bb_head;
 
 struct match {
@@ -1744,6 +1750,283 @@ replacement_quality(reg)
   return 2;
 }
 
+/* The scans below for the next (or previous) insn involving a pair of
+   registers stop at labels, jumps, calls and loop notes, and look closely
+   only at insns that mention one of the registers; every other insn is
+   just counted.  In long basic blocks those scans become quadratic, so
+   once a scan has gone past REFS_MIN_SCAN real insns it asks this index
+   where the next insn it needs to look at is.
+
+   The index is built from the insn chain and goes stale when
+   insn_chain_epoch shows that the chain has changed since.  A stale
+   index is not used.  Every transformation makes it stale, so it is
+   only rebuilt once the scans have walked REFS_BUILD_COST insns for
+   each insn in the chain, a rebuild doing about that much work per
+   insn.  Rebuilding then costs no more than the walks did, and
+   functions where few scans are long never build it at all.
+
+   refs_luid[UID] is the position in the chain of the insn with that uid,
+   or -1 if it had none when the index was built, and refs_insn[POS] is
+   the insn at POS.  refs_n_real[POS] counts the real insns before POS.
+   The positions of the insns mentioning pseudo R are in ascending order
+   in refs_pos, starting at refs_start[R] and ending before
+   refs_start[R + 1].  refs_stop holds the positions of the insns that
+   end every scan.  */
+
+#define REFS_MIN_SCAN 32
+#define REFS_BUILD_COST 4
+
+static int *refs_luid;
+static int refs_max_uid;
+static rtx *refs_insn;
+static int *refs_n_real;
+static int refs_n_insns;
+static int *refs_start;
+static int *refs_pos;
+static int refs_nregs;
+static int *refs_stop;
+static int refs_n_stops;
+static int refs_epoch;
+
+/* The number of insns the scans have walked one by one since the index
+   was last built, or since the start of the function.  */
+
+static int refs_walked;
+
+/* Used by note_pseudo_ref to collect the pseudos each insn mentions.
+   refs_last[R] is the last position at which pseudo R was seen.  */
+
+static int *refs_last;
+static int refs_cur_pos;
+static int *refs_pair_regno;
+static int *refs_pair_pos;
+static int refs_n_pairs;
+static int refs_pairs_allocated;
+
+/* Called via for_each_rtx.  Record that the insn at refs_cur_pos
+   mentions the pseudo *LOC, if it is one.  */
+
+static int
+note_pseudo_ref (loc, data)
+     rtx *loc;
+     void *data ATTRIBUTE_UNUSED;
+{
+  rtx x = *loc;
+  int regno;
+
+  if (x == 0 || GET_CODE (x) != REG || REGNO (x) < FIRST_PSEUDO_REGISTER)
+    return 0;
+
+  regno = REGNO (x);
+  if (refs_last[regno] == refs_cur_pos)
+    return 0;
+  refs_last[regno] = refs_cur_pos;
+
+  if (refs_n_pairs == refs_pairs_allocated)
+    {
+      refs_pairs_allocated = refs_pairs_allocated * 2 + 256;
+      refs_pair_regno = (int *) xrealloc (refs_pair_regno,
+					  refs_pairs_allocated * sizeof (int));
+      refs_pair_pos = (int *) xrealloc (refs_pair_pos,
+					refs_pairs_allocated * sizeof (int));
+    }
+
+  refs_pair_regno[refs_n_pairs] = regno;
+  refs_pair_pos[refs_n_pairs] = refs_cur_pos;
+  refs_n_pairs++;
+  return 0;
+}
+
+/* Build the index of pseudo register references described above from
+   the current insn chain.  */
+
+static void
+index_pseudo_refs ()
+{
+  rtx insn, link;
+  int i, n;
+
+  free_pseudo_refs ();
+
+  for (n = 0, insn = get_insns (); insn; insn = NEXT_INSN (insn))
+    n++;
+
+  refs_max_uid = get_max_uid ();
+  refs_nregs = max_reg_num ();
+  refs_n_insns = n;
+  refs_luid = (int *) xmalloc (refs_max_uid * sizeof (int));
+  refs_insn = (rtx *) xmalloc ((n + 1) * sizeof (rtx));
+  refs_n_real = (int *) xmalloc ((n + 1) * sizeof (int));
+  refs_start = (int *) xcalloc (refs_nregs + 1, sizeof (int));
+  refs_stop = (int *) xmalloc ((n + 1) * sizeof (int));
+  refs_last = (int *) xmalloc (refs_nregs * sizeof (int));
+  for (i = 0; i < refs_max_uid; i++)
+    refs_luid[i] = -1;
+  for (i = 0; i < refs_nregs; i++)
+    refs_last[i] = -1;
+
+  refs_n_stops = 0;
+  refs_n_pairs = 0;
+  refs_n_real[0] = 0;
+  for (n = 0, insn = get_insns (); insn; n++, insn = NEXT_INSN (insn))
+    {
+      refs_luid[INSN_UID (insn)] = n;
+      refs_insn[n] = insn;
+      refs_n_real[n + 1] = refs_n_real[n];
+
+      if (GET_CODE (insn) == CODE_LABEL || GET_CODE (insn) == JUMP_INSN
+	  || GET_CODE (insn) == CALL_INSN
+	  || (GET_CODE (insn) == NOTE
+	      && (NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_BEG
+		  || NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_END)))
+	refs_stop[refs_n_stops++] = n;
+
+      if (GET_RTX_CLASS (GET_CODE (insn)) != 'i')
+	continue;
+
+      refs_n_real[n + 1]++;
+      refs_cur_pos = n;
+      for_each_rtx (&PATTERN (insn), note_pseudo_ref, NULL);
+      for (link = REG_NOTES (insn); link; link = XEXP (link, 1))
+	if (GET_CODE (link) == EXPR_LIST)
+	  for_each_rtx (&XEXP (link, 0), note_pseudo_ref, NULL);
+      if (GET_CODE (insn) == CALL_INSN)
+	for_each_rtx (&CALL_INSN_FUNCTION_USAGE (insn), note_pseudo_ref, NULL);
+    }
+
+  /* Sort the references by register, keeping each register's
+     positions in ascending order.  */
+  for (i = 0; i < refs_n_pairs; i++)
+    refs_start[refs_pair_regno[i] + 1]++;
+  for (i = 0; i < refs_nregs; i++)
+    refs_start[i + 1] += refs_start[i];
+
+  refs_pos = (int *) xmalloc ((refs_n_pairs + 1) * sizeof (int));
+  for (i = 0; i < refs_nregs; i++)
+    refs_last[i] = refs_start[i];
+  for (i = 0; i < refs_n_pairs; i++)
+    refs_pos[refs_last[refs_pair_regno[i]]++] = refs_pair_pos[i];
+
+  refs_epoch = insn_chain_epoch;
+}
+
+/* Free the index of pseudo register references, if there is one.  */
+
+static void
+free_pseudo_refs ()
+{
+  refs_walked = 0;
+  if (refs_insn == 0)
+    return;
+
+  free (refs_luid);
+  free (refs_insn);
+  free (refs_n_real);
+  free (refs_start);
+  free (refs_pos);
+  free (refs_stop);
+  free (refs_last);
+  refs_insn = 0;
+}
+
+/* Return the index of the first of the N ascending positions in VEC
+   that is after POS, or N if there is none.  */
+
+static int
+refs_after (vec, n, pos)
+     int *vec;
+     int n, pos;
+{
+  int lo = 0, hi = n;
+
+  while (lo < hi)
+    {
+      int mid = (lo + hi) / 2;
+
+      if (vec[mid] <= pos)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  return lo;
+}
+
+/* Return the position of the first insn after POS (before POS, if
+   BACKWARD) that mentions pseudo REGNO, or one past the end of the
+   chain (-1, if BACKWARD) if there is none.  */
+
+static int
+refs_near (regno, pos, backward)
+     int regno, pos, backward;
+{
+  int *vec = refs_pos + refs_start[regno];
+  int n = refs_start[regno + 1] - refs_start[regno];
+  int i = refs_after (vec, n, pos);
+
+  if (backward)
+    {
+      /* Step back over POS itself, if it is in the list.  */
+      if (i > 0 && vec[i - 1] == pos)
+	i--;
+      return i > 0 ? vec[i - 1] : -1;
+    }
+
+  return i < n ? vec[i] : refs_n_insns;
+}
+
+/* INSN is being passed over by a scan forward (backward, if BACKWARD)
+   for insns involving pseudos REGNO1 and REGNO2.  Return the insn just
+   before (after, if BACKWARD) the next insn that the scan must look at,
+   which may be INSN itself, and store in *PN_REAL the number of real
+   insns that lie between INSN and the returned insn, counting the
+   latter.  If the index is stale or does not cover INSN, return
+   INSN.  */
+
+static rtx
+skip_unrelated_insns (insn, regno1, regno2, backward, pn_real)
+     rtx insn;
+     int regno1, regno2, backward;
+     int *pn_real;
+{
+  int uid = INSN_UID (insn);
+  int pos, target, i;
+
+  *pn_real = 0;
+
+  if (refs_insn == 0 || refs_epoch != insn_chain_epoch)
+    {
+      if (++refs_walked
+	  < REFS_BUILD_COST * (refs_insn ? refs_n_insns : get_max_uid ()))
+	return insn;
+      index_pseudo_refs ();
+    }
+
+  if (uid >= refs_max_uid || (pos = refs_luid[uid]) < 0
+      || regno1 < FIRST_PSEUDO_REGISTER || regno2 < FIRST_PSEUDO_REGISTER
+      || regno1 >= refs_nregs || regno2 >= refs_nregs)
+    return insn;
+
+  if (backward)
+    {
+      i = refs_after (refs_stop, refs_n_stops, pos);
+      if (i > 0 && refs_stop[i - 1] == pos)
+	i--;
+      target = MAX (i > 0 ? refs_stop[i - 1] : -1,
+		    MAX (refs_near (regno1, pos, 1),
+			 refs_near (regno2, pos, 1)));
+      *pn_real = refs_n_real[pos] - refs_n_real[target + 1];
+      return refs_insn[target + 1];
+    }
+
+  i = refs_after (refs_stop, refs_n_stops, pos);
+  target = MIN (i < refs_n_stops ? refs_stop[i] : refs_n_insns,
+		MIN (refs_near (regno1, pos, 0),
+		     refs_near (regno2, pos, 0)));
+  *pn_real = refs_n_real[target] - refs_n_real[pos + 1];
+  return refs_insn[target - 1];
+}
+
 /* INSN is a copy from SRC to DEST, both registers, and SRC does not die
    in INSN.
 
@@ -1766,6 +2049,7 @@ optimize_reg_copy_1 (insn, dest, src)
   rtx dest_death = 0;
   int sregno = REGNO (src);
   int dregno = REGNO (dest);
+  int scanned = 0, skipped;
 
   /* We don't want to mess with hard regs if register classes are small. */
   if (sregno == dregno
@@ -1941,6 +2225,9 @@ optimize_reg_copy_1 (insn, dest, src)
       else if (sregno < FIRST_PSEUDO_REGISTER
 	       && dead_or_set_p (p, src))
 	break;
+
+      if (++scanned > REFS_MIN_SCAN)
+	p = skip_unrelated_insns (p, sregno, dregno, 0, &skipped);
     }
   return 0;
 }
@@ -1969,6 +2256,7 @@ optimize_reg_copy_2 (insn, dest, src)
   rtx set;
   int sregno = REGNO (src);
   int dregno = REGNO (dest);
+  int scanned = 0, skipped;
 
   for (p = NEXT_INSN (insn); p; p = NEXT_INSN (p))
     {
@@ -2030,6 +2318,9 @@ optimize_reg_copy_2 (insn, dest, src)
 	  || find_reg_note (p, REG_DEAD, dest)
 	  || (GET_CODE (p) == CALL_INSN && REG_N_CALLS_CROSSED (sregno) == 0))
 	break;
+
+      if (++scanned > REFS_MIN_SCAN)
+	p = skip_unrelated_insns (p, sregno, dregno, 0, &skipped);
     }
 }
 /* INSN is a ZERO_EXTEND or SIGN_EXTEND of SRC to DEST.
@@ -2485,7 +2776,10 @@ regmove_optimize (f, nregs, regmove_dump_file)
   for (pass = 0; pass <= 2; pass++)
     {
       if (! flag_regmove && pass >= flag_expensive_optimizations)
-	return;
+	{
+	  free_pseudo_refs ();
+	  return;
+	}
 
       if (regmove_dump_file)
 	fprintf (regmove_dump_file, "Starting %s pass...\n",
@@ -2688,6 +2982,7 @@ regmove_optimize (f, nregs, regmove_dump_file)
 	      int num_calls = 0;
 	      enum reg_class src_class, dst_class;
 	      int length;
+	      int scanned = 0, skipped;
 
 	      match_no = match.with[op_no];
 
@@ -2868,6 +3163,13 @@ regmove_optimize (f, nregs, regmove_dump_file)
 		      if (REG_N_CALLS_CROSSED (REGNO (dst)) == 0)
 			break;
 		    }
+
+		  if (++scanned > REFS_MIN_SCAN)
+		    {
+		      p = skip_unrelated_insns (p, REGNO (src), REGNO (dst),
+						1, &skipped);
+		      length += skipped;
+		    }
 		}
 
 	      if (success)
@@ -2955,6 +3257,8 @@ regmove_optimize (f, nregs, regmove_dump_file)
 	new = next, next = NEXT_INSN (new);
       BLOCK_END (i) = new;
     }
+
+  free_pseudo_refs ();
 }
 
 /* Returns nonzero if INSN's pattern has matching constraints for any operand.
@@ -3059,6 +3363,7 @@ fixup_match_1 (insn, set, src, src_subreg, dst, backward, operand_number,
   rtx overlap = 0; /* need to move insn ? */
   rtx src_note = find_reg_note (insn, REG_DEAD, src), dst_note;
   int length, s_length, true_loop_depth;
+  int scanned = 0, skipped;
 
   if (! src_note)
     {
@@ -3263,6 +3568,14 @@ fixup_match_1 (insn, set, src, src_subreg, dst, backward, operand_number,
 	    s_num_calls++;
 
 	}
+
+      if (++scanned > REFS_MIN_SCAN)
+	{
+	  p = skip_unrelated_insns (p, REGNO (src), REGNO (dst), 0, &skipped);
+	  length += skipped;
+	  if (src_note)
+	    s_length += skipped;
+	}
     }
 
   if (! success)
@@ -263,6 +263,12 @@ static int subst_reg_equivs_changed;
    operand, which can be different for that from the input operand.  */
 static int output_reloadnum;
 
+/* Set to 1 by find_equiv_reg, cleared on entry to find_reloads.  An
+   analysis that looked for an equivalent register depends on the insns
+   before this one and on the spill registers, so reload1.c must not
+   reuse it on a later pass.  */
+int find_equiv_reg_used;
+
   /* Compare two RTX's.  */
 #define MATCHES(x, y) \
  (x == y || (x != 0 && (GET_CODE (x) == REG				\
@@ -2274,6 +2280,7 @@ find_reloads (insn, replace, ind_levels, live_known, reload_reg_p)
   replace_reloads = replace;
   hard_regs_live_known = live_known;
   static_reload_reg_p = reload_reg_p;
+  find_equiv_reg_used = 0;
 
   /* JUMP_INSNs and CALL_INSNs are not allowed to have any output reloads;
      neither are insns that SET cc0.  Insns that use CC0 are not allowed
@@ -5837,6 +5844,8 @@ find_equiv_reg (goal, insn, class, other, reload_reg_p, goalreg, mode)
   int nregs;
   int valuenregs;
 
+  find_equiv_reg_used = 1;
+
   if (goal == 0)
     regno = goalreg;
   else if (GET_CODE (goal) == REG)
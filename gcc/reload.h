@@ -124,6 +124,9 @@ extern int reload_n_operands;
    Used in find_equiv_reg.  */
 extern int reload_first_uid;
 
+/* Nonzero if the last call to find_reloads used find_equiv_reg.  */
+extern int find_equiv_reg_used;
+
 /* Nonzero if indirect addressing is supported when the innermost MEM is
    of the form (MEM (SYMBOL_REF sym)).  It is assumed that the level to
    which these are valid is the same as spill_indirect_levels, above.   */
@@ -290,6 +290,41 @@ extern union tree_node *current_function_decl;
 
 /* List of all insns needing reloads.  */
 static struct insn_chain *insns_need_reload;
+
+/* Memoization of find_reloads across the passes of the main loop in
+   `reload'.  Each pass reanalyzes every insn, but only those mentioning
+   a pseudo that was just spilled, or an eliminable register whose offset
+   moved, can come out differently.  So for each insn we build a key
+   describing everything find_reloads will look at -- the pattern after
+   elimination and its notes, the hard registers and equivalences of the
+   pseudos it mentions and, when an eliminable register is involved, the
+   state of the elimination table -- and save it together with what
+   calculate_needs derived from the analysis.  If the key is the same on
+   a later pass, the saved results are used instead.  */
+
+struct reload_memo
+{
+  /* The key; KEY_LEN is -1 if nothing valid is recorded.  */
+  size_t *key;
+  int key_len;
+  int key_alloc;
+
+  /* The results of find_reloads and calculate_needs.  */
+  int n_reloads;
+  int operands_changed;
+  struct needs need;
+  char group_size[N_REG_CLASSES];
+  enum machine_mode group_mode[N_REG_CLASSES];
+};
+
+/* Indexed by INSN_UID; allocated when a second pass is needed.  Insns
+   made after that, such as caller save insns, have no entry and are
+   always analyzed.  */
+static struct reload_memo **reload_memo;
+static int reload_memo_max_uid;
+
+/* The memos and their keys are allocated here.  */
+static struct obstack reload_memo_obstack;
 
 /* This structure is used to record information about register eliminations.
    Each array entry describes one possible way of eliminating a register
@@ -359,6 +394,11 @@ struct hard_reg_n_uses
 };
 
 static void maybe_fix_stack_asms	(void);
+static void grow_memo_key		(void);
+static int memo_key_rtx			(rtx, int);
+static int memo_insn_key		(rtx, int);
+static struct reload_memo *lookup_reload_memo (int);
+static struct reload_memo *record_reload_memo (int);
 static void calculate_needs_all_insns	(int);
 static void calculate_needs		(struct insn_chain *);
 static void find_reload_regs		(struct insn_chain *chain,
@@ -973,6 +1013,18 @@ reload (first, global, dumpfile)
 
       if (caller_save_needed)
 	delete_caller_save_insns ();
+
+      /* Most functions need only one pass.  Once we know there will be
+	 another, start memoizing the analysis of each insn.  */
+      if (reload_memo == 0)
+	{
+	  reload_memo_max_uid = get_max_uid ();
+	  reload_memo = (struct reload_memo **)
+	    xmalloc (reload_memo_max_uid * sizeof (struct reload_memo *));
+	  zero_memory ((char *) reload_memo,
+		       reload_memo_max_uid * sizeof (struct reload_memo *));
+	  gcc_obstack_init (&reload_memo_obstack);
+	}
     }
 
   /* If global-alloc was run, notify it of any register eliminations we have
@@ -1172,6 +1224,13 @@ reload (first, global, dumpfile)
   free (reg_old_renumber);
   free (pseudo_previous_regs);
   free (pseudo_forbidden_regs);
+  if (reload_memo)
+    {
+      obstack_free (&reload_memo_obstack, NULL);
+      free (reload_memo);
+      reload_memo = 0;
+      reload_memo_max_uid = 0;
+    }
 
   FREE_REG_SET (spilled_pseudos);
 
@@ -1198,6 +1257,251 @@ maybe_fix_stack_asms ()
 }
 
 
+/* The key of the insn being analyzed is built here.  */
+static size_t *memo_key;
+static int memo_key_len;
+static int memo_key_alloc;
+
+/* Nonzero if the key being built mentions an eliminable register.  */
+static int memo_key_elim;
+
+/* The rtx's already entered in the key being built, so that shared
+   subexpressions are recorded as such and the equivalences of a pseudo
+   are walked only once.  An entry is in use if its stamp matches
+   memo_seen_stamp.  */
+#define MEMO_SEEN_SIZE 256
+static rtx memo_seen_rtx[MEMO_SEEN_SIZE];
+static int memo_seen_index[MEMO_SEEN_SIZE];
+static int memo_seen_stamp_of[MEMO_SEEN_SIZE];
+static int memo_seen_stamp;
+static int memo_seen_count;
+
+/* How deeply equivalences of pseudos inside equivalences are followed
+   before giving up on the insn.  */
+#define MEMO_MAX_EQUIV_DEPTH 4
+
+static void
+grow_memo_key ()
+{
+  memo_key_alloc = memo_key_alloc ? memo_key_alloc * 2 : 64;
+  memo_key = (size_t *) xrealloc (memo_key, memo_key_alloc * sizeof (size_t));
+}
+
+#define MEMO_KEY_PUSH(WORD)				\
+  do {							\
+    if (memo_key_len == memo_key_alloc)			\
+      grow_memo_key ();					\
+    memo_key[memo_key_len++] = (size_t) (WORD);		\
+  } while (0)
+
+/* Append X to the key being built.  DEPTH is the number of pseudo
+   equivalences we are inside.  Return 0 if X is too big or too deep to
+   be described, in which case the insn is not memoized.  */
+
+static int
+memo_key_rtx (x, depth)
+     rtx x;
+     int depth;
+{
+  register enum rtx_code code;
+  register char *fmt;
+  register int i, j;
+  int h;
+
+  if (x == 0)
+    {
+      MEMO_KEY_PUSH ((size_t) -1);
+      return 1;
+    }
+
+  h = ((size_t) x >> 3) % MEMO_SEEN_SIZE;
+  while (memo_seen_stamp_of[h] == memo_seen_stamp)
+    {
+      if (memo_seen_rtx[h] == x)
+	{
+	  MEMO_KEY_PUSH ((size_t) -2);
+	  MEMO_KEY_PUSH ((size_t) memo_seen_index[h]);
+	  return 1;
+	}
+      h = (h + 1) % MEMO_SEEN_SIZE;
+    }
+  if (memo_seen_count >= MEMO_SEEN_SIZE / 2)
+    return 0;
+  memo_seen_stamp_of[h] = memo_seen_stamp;
+  memo_seen_rtx[h] = x;
+  memo_seen_index[h] = memo_seen_count++;
+
+  code = GET_CODE (x);
+  MEMO_KEY_PUSH ((size_t) code | (size_t) GET_MODE (x) << 16
+		 | (size_t) x->jump << 24 | (size_t) x->call << 25
+		 | (size_t) x->unchanging << 26 | (size_t) x->volatil << 27
+		 | (size_t) x->in_struct << 28 | (size_t) x->integrated << 29
+		 | (size_t) x->frame_related << 30);
+
+  if (code == REG)
+    {
+      int regno = REGNO (x);
+
+      /* Registers are compared against frame_pointer_rtx and the like,
+	 so record which rtx this is as well as its number.  */
+      MEMO_KEY_PUSH ((size_t) x);
+      MEMO_KEY_PUSH ((size_t) regno);
+      if (regno < FIRST_PSEUDO_REGISTER)
+	{
+	  struct elim_table *ep;
+
+	  for (ep = reg_eliminate; ep < &reg_eliminate[NUM_ELIMINABLE_REGS];
+	       ep++)
+	    if (ep->from == regno)
+	      memo_key_elim = 1;
+	  return 1;
+	}
+
+      MEMO_KEY_PUSH ((size_t) reg_renumber[regno]);
+      if (reg_equiv_constant[regno] == 0 && reg_equiv_memory_loc[regno] == 0
+	  && reg_equiv_address[regno] == 0 && reg_equiv_mem[regno] == 0)
+	return 1;
+      if (depth == MEMO_MAX_EQUIV_DEPTH)
+	return 0;
+      return (memo_key_rtx (reg_equiv_constant[regno], depth + 1)
+	      && memo_key_rtx (reg_equiv_memory_loc[regno], depth + 1)
+	      && memo_key_rtx (reg_equiv_address[regno], depth + 1)
+	      && memo_key_rtx (reg_equiv_mem[regno], depth + 1));
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = 0; i < GET_RTX_LENGTH (code); i++)
+    switch (fmt[i])
+      {
+      case 'e':
+	if (! memo_key_rtx (XEXP (x, i), depth))
+	  return 0;
+	break;
+
+      case 'E':
+      case 'V':
+	if (XVEC (x, i) == 0)
+	  {
+	    MEMO_KEY_PUSH ((size_t) -1);
+	    break;
+	  }
+	MEMO_KEY_PUSH ((size_t) XVECLEN (x, i));
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  if (! memo_key_rtx (XVECEXP (x, i, j), depth))
+	    return 0;
+	break;
+
+      case 'u':
+	MEMO_KEY_PUSH (XEXP (x, i) ? (size_t) INSN_UID (XEXP (x, i))
+		       : (size_t) -1);
+	break;
+
+      case 'i':
+      case 'n':
+	MEMO_KEY_PUSH ((size_t) XINT (x, i));
+	break;
+
+      case 'w':
+	MEMO_KEY_PUSH ((size_t) XWINT (x, i));
+	break;
+
+      case 's':
+      case 'S':
+	MEMO_KEY_PUSH ((size_t) XSTR (x, i));
+	break;
+
+      default:
+	break;
+      }
+
+  return 1;
+}
+
+/* Build in memo_key the key for analyzing INSN with find_reloads; GLOBAL
+   is passed on to it.  Return 0 if INSN cannot be memoized.  */
+
+static int
+memo_insn_key (insn, global)
+     rtx insn;
+     int global;
+{
+  memo_key_len = 0;
+  memo_key_elim = 0;
+  memo_seen_count = 0;
+  memo_seen_stamp++;
+
+  MEMO_KEY_PUSH ((size_t) GET_CODE (insn));
+  MEMO_KEY_PUSH ((size_t) global);
+  MEMO_KEY_PUSH ((size_t) spill_indirect_levels);
+
+  if (! memo_key_rtx (PATTERN (insn), 0)
+      || ! memo_key_rtx (REG_NOTES (insn), 0)
+      || (GET_CODE (insn) == CALL_INSN
+	  && ! memo_key_rtx (CALL_INSN_FUNCTION_USAGE (insn), 0)))
+    return 0;
+
+  if (memo_key_elim)
+    {
+      struct elim_table *ep;
+
+      MEMO_KEY_PUSH ((size_t) num_not_at_initial_offset);
+      for (ep = reg_eliminate; ep < &reg_eliminate[NUM_ELIMINABLE_REGS]; ep++)
+	{
+	  MEMO_KEY_PUSH ((size_t) ep->to);
+	  MEMO_KEY_PUSH ((size_t) ep->can_eliminate);
+	  MEMO_KEY_PUSH ((size_t) ep->initial_offset);
+	  MEMO_KEY_PUSH ((size_t) ep->offset);
+	  MEMO_KEY_PUSH ((size_t) ep->previous_offset);
+	}
+    }
+
+  return 1;
+}
+
+/* Return the memo for insn number UID if it was recorded under the key
+   now in memo_key.  */
+
+static struct reload_memo *
+lookup_reload_memo (uid)
+     int uid;
+{
+  struct reload_memo *memo = reload_memo[uid];
+
+  if (memo != 0 && memo->key_len == memo_key_len
+      && ! memcmp ((char *) memo->key, (char *) memo_key,
+		   memo_key_len * sizeof (size_t)))
+    return memo;
+  return 0;
+}
+
+/* Record the key now in memo_key for insn number UID, replacing any
+   previous one, and return the memo.  */
+
+static struct reload_memo *
+record_reload_memo (uid)
+     int uid;
+{
+  struct reload_memo *memo = reload_memo[uid];
+
+  if (memo == 0)
+    {
+      memo = (struct reload_memo *)
+	obstack_alloc (&reload_memo_obstack, sizeof (struct reload_memo));
+      memo->key_alloc = 0;
+      reload_memo[uid] = memo;
+    }
+  if (memo->key_alloc < memo_key_len)
+    {
+      memo->key_alloc = memo_key_len;
+      memo->key = (size_t *) obstack_alloc (&reload_memo_obstack,
+					    memo_key_len * sizeof (size_t));
+    }
+  copy_memory ((char *) memo_key, (char *) memo->key,
+	       memo_key_len * sizeof (size_t));
+  memo->key_len = memo_key_len;
+  return memo;
+}
+
 /* Walk the chain of insns, and determine for each whether it needs reloads
    and/or eliminations.  Build the corresponding insns_need_reload list, and
    set something_needs_elimination as appropriate.  */
@@ -1234,6 +1538,10 @@ calculate_needs_all_insns (global)
 	  rtx old_notes = REG_NOTES (insn);
 	  int did_elimination = 0;
 	  int operands_changed = 0;
+	  int insn_n_reloads;
+	  int memoizable = 0;
+	  int memo_hit = 0;
+	  struct reload_memo *memo = 0;
 	  rtx set = single_set (insn);
 
 	  /* Skip insns that only set an equivalence.  */
@@ -1253,9 +1561,43 @@ calculate_needs_all_insns (global)
 	  if (num_eliminable || num_eliminable_invariants)
 	    did_elimination = eliminate_regs_in_insn (insn, 0);
 
-	  /* Analyze the instruction.  */
-	  operands_changed = find_reloads (insn, 0, spill_indirect_levels,
-					   global, spill_reg_order);
+	  /* Analyze the instruction, unless an earlier pass already did
+	     so under exactly the same conditions.  */
+	  if (INSN_UID (insn) < reload_memo_max_uid
+	      && GET_CODE (PATTERN (insn)) != ASM_INPUT
+	      && asm_noperands (PATTERN (insn)) < 0)
+	    memoizable = memo_insn_key (insn, global);
+	  if (memoizable)
+	    memo = lookup_reload_memo (INSN_UID (insn));
+
+	  if (memo)
+	    {
+	      memo_hit = 1;
+	      operands_changed = memo->operands_changed;
+	      insn_n_reloads = memo->n_reloads;
+	    }
+	  else
+	    {
+	      HOST_WIDE_INT frame_size = get_frame_size ();
+
+	      operands_changed = find_reloads (insn, 0, spill_indirect_levels,
+					       global, spill_reg_order);
+	      insn_n_reloads = n_reloads;
+
+	      /* The analysis can be reused only if it did not depend on
+		 the insns before this one and did not allocate stack
+		 slots.  If find_reloads changed INSN, that shows up in
+		 the key on the next pass.  */
+	      if (memoizable && ! find_equiv_reg_used
+		  && frame_size == get_frame_size ())
+		{
+		  memo = record_reload_memo (INSN_UID (insn));
+		  memo->n_reloads = insn_n_reloads;
+		  memo->operands_changed = operands_changed;
+		}
+	      else if (memoizable && reload_memo[INSN_UID (insn)])
+		reload_memo[INSN_UID (insn)]->key_len = -1;
+	    }
 
 	  /* If a no-op set needs more than one reload, this is likely
 	     to be something that needs input address reloads.  We
@@ -1264,7 +1606,7 @@ calculate_needs_all_insns (global)
 	     We only do this when expensive_optimizations is enabled,
 	     since this complements reload inheritance / output
 	     reload deletion, and it can make debugging harder.  */
-	  if (flag_expensive_optimizations && n_reloads > 1)
+	  if (flag_expensive_optimizations && insn_n_reloads > 1)
 	    {
 	      rtx set = single_set (insn);
 	      if (set
@@ -1284,7 +1626,7 @@ calculate_needs_all_insns (global)
 	  /* Remember for later shortcuts which insns had any reloads or
 	     register eliminations.  */
 	  chain->need_elim = did_elimination;
-	  chain->need_reload = n_reloads > 0;
+	  chain->need_reload = insn_n_reloads > 0;
 	  chain->need_operand_change = operands_changed;
 
 	  /* Discard any register replacements done.  */
@@ -1299,12 +1641,33 @@ calculate_needs_all_insns (global)
 
 	  something_needs_operands_changed |= operands_changed;
 
-	  if (n_reloads != 0)
+	  if (insn_n_reloads != 0)
 	    {
 	      *pprev_reload = chain;
 	      pprev_reload = &chain->next_need_reload;
 
-	      calculate_needs (chain);
+	      if (memo_hit)
+		{
+		  chain->need = memo->need;
+		  copy_memory (memo->group_size, chain->group_size,
+			       sizeof chain->group_size);
+		  copy_memory ((char *) memo->group_mode,
+			       (char *) chain->group_mode,
+			       sizeof chain->group_mode);
+		}
+	      else
+		{
+		  calculate_needs (chain);
+		  if (memo)
+		    {
+		      memo->need = chain->need;
+		      copy_memory (chain->group_size, memo->group_size,
+				   sizeof memo->group_size);
+		      copy_memory ((char *) chain->group_mode,
+				   (char *) memo->group_mode,
+				   sizeof memo->group_mode);
+		    }
+		}
 	    }
 	}
     }
@@ -1210,6 +1210,23 @@ extern int reload_completed;
 
 extern int reload_in_progress;
 
+/* Bumped by emit-rtl.c, delete_insn, validate_change and the other
+   primitives whenever the insn chain, an insn's pattern or its notes
+   change.  While it keeps a value read earlier, no edit visible to
+   those primitives has been made since.  That alone does not make
+   rerunning a pass a no-op, since a pass may depend on other state.
+   Passes that edit rtl in place behind the primitives' backs bump it
+   themselves.  */
+extern int insn_chain_epoch;
+
+/* Bumped along with insn_chain_epoch when an insn already in the chain
+   has its code, pattern or notes changed in place, but not when insns
+   are added, removed or moved, nor when a LABEL_REF is just pointed at
+   another label.  Facts cached about single insns stay true while this
+   is unchanged, as long as the insns are checked to still be where
+   they were found.  */
+extern int insn_edit_epoch;
+
 /* If this is nonzero, we do not bother generating VOLATILE
    around volatile memory references, and we are willing to
    output indirect addresses.  If cse is to follow, we reject
@@ -1508,6 +1525,8 @@ extern int output_dependence		(rtx, rtx);
 extern void init_alias_once		(void);
 extern void init_alias_analysis		(void);
 extern void end_alias_analysis		(void);
+extern void begin_alias_memo		(void);
+extern void end_alias_memo		(void);
 
 extern void record_base_value		(int, rtx, int);
 extern void record_alias_subset         (int, int);
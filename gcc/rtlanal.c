@@ -36,6 +36,14 @@ static int jmp_uses_reg_or_mem		(rtx);
    and set by `-m...' switches.  Must be defined in rtlanal.c.  */
 
 int target_flags;
+
+/* Modification count of the insn chain; see the comment in rtl.h.
+   It is never reset, so a value recorded for one function can not
+   match in the next.  Defined here rather than in emit-rtl.c because
+   remove_note bumps it and the generator programs link this file.  */
+
+int insn_chain_epoch;
+int insn_edit_epoch;
 
 /* Return 1 if the value of X is unstable
    (would be different at a different point in the program).
@@ -1509,6 +1517,8 @@ remove_note (insn, note)
 {
   register rtx link;
 
+  insn_chain_epoch++;
+  insn_edit_epoch++;
   if (REG_NOTES (insn) == note)
     {
       REG_NOTES (insn) = XEXP (note, 1);
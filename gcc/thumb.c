@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "config.h"
+#include "system.h"
 #include "rtl.h"
 #include "hard-reg-set.h"
 #include "regs.h"
@@ -129,11 +130,13 @@ thumb_shiftable_const(HOST_WIDE_INT val)
 
  */
 
-typedef struct
+typedef struct pool_node
 {
     rtx value;                  /* Value in table */
     HOST_WIDE_INT next_offset;
     enum machine_mode mode;     /* Mode of value */
+    unsigned int hash;          /* Bucket in pool_hash_table */
+    struct pool_node *hash_next; /* Next constant in the same bucket */
 } pool_node;
 
 /* The maximum number of constants that can fit into one pool, since
@@ -145,13 +148,97 @@ static pool_node pool_vector[MAX_POOL_SIZE];
 static int pool_size;
 static rtx pool_vector_label;
 
+/* The constants in pool_vector, hashed by pool_hash so that add_constant
+   need not compare a new constant with every one already in the pool. */
+
+#define POOL_HASH_SIZE 256
+static pool_node *pool_hash_table[POOL_HASH_SIZE];
+
+/* Return a hash code for X which is the same for any two rtx's that
+   rtx_equal_p considers equal. */
+
+static unsigned int
+pool_hash(rtx x)
+{
+    enum rtx_code code;
+    unsigned int hash;
+    char *fmt;
+    char *p;
+    int i, j;
+
+    if (x == 0)
+        return 0;
+
+    code = GET_CODE(x);
+    hash = (unsigned int) code * 67 + (unsigned int) GET_MODE(x);
+
+    /* These are compared without looking at their operands.  Addresses
+       are shifted since their low bits are usually zero. */
+    switch (code)
+    {
+    case REG:
+        return hash + REGNO(x);
+
+    case LABEL_REF:
+        return hash + (unsigned int) ((unsigned long) XEXP(x, 0) >> 3);
+
+    case SYMBOL_REF:
+        return hash + (unsigned int) ((unsigned long) XSTR(x, 0) >> 3);
+
+    case SCRATCH:
+    case CONST_DOUBLE:
+        return hash + (unsigned int) ((unsigned long) x >> 3);
+
+    default:
+        break;
+    }
+
+    fmt = GET_RTX_FORMAT(code);
+    for (i = GET_RTX_LENGTH(code) - 1; i >= 0; i--)
+    {
+        switch (fmt[i])
+        {
+        case 'w':
+            hash = hash * 31 + (unsigned int) XWINT(x, i);
+            break;
+
+        case 'n':
+        case 'i':
+            hash = hash * 31 + (unsigned int) XINT(x, i);
+            break;
+
+        case 'V':
+        case 'E':
+            for (j = 0; j < XVECLEN(x, i); j++)
+                hash = hash * 31 + pool_hash(XVECEXP(x, i, j));
+            break;
+
+        case 'e':
+            hash = hash * 31 + pool_hash(XEXP(x, i));
+            break;
+
+        case 'S':
+        case 's':
+            if (XSTR(x, i))
+                for (p = XSTR(x, i); *p; p++)
+                    hash = hash * 31 + (unsigned char) *p;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return hash;
+}
+
 /* Add a constant to the pool and return its label.  */
 
 static HOST_WIDE_INT
 add_constant(rtx x, enum machine_mode mode)
 {
-    int i;
-    rtx lab;
+    pool_node *p;
+    unsigned int hash;
     HOST_WIDE_INT offset;
 
     if (mode == SImode && GET_CODE(x) == MEM && CONSTANT_P(XEXP(x, 0))
@@ -160,18 +247,19 @@ add_constant(rtx x, enum machine_mode mode)
 
     /* First see if we've already got it */
 
-    for (i = 0; i < pool_size; i++)
+    hash = (pool_hash(x) + (unsigned int) mode) % POOL_HASH_SIZE;
+    for (p = pool_hash_table[hash]; p; p = p->hash_next)
     {
-        if (x->code == pool_vector[i].value->code
-            && mode == pool_vector[i].mode)
+        if (x->code == p->value->code
+            && mode == p->mode)
         {
             if (x->code == CODE_LABEL)
             {
-                if (XINT(x, 3) != XINT(pool_vector[i].value, 3))
+                if (XINT(x, 3) != XINT(p->value, 3))
                     continue;
             }
-            if (rtx_equal_p(x, pool_vector[i].value))
-                return pool_vector[i].next_offset - GET_MODE_SIZE(mode);
+            if (rtx_equal_p(x, p->value))
+                return p->next_offset - GET_MODE_SIZE(mode);
         }
     }
 
@@ -187,13 +275,17 @@ add_constant(rtx x, enum machine_mode mode)
 
     pool_vector[pool_size].value = x;
     pool_vector[pool_size].mode = mode;
+    pool_vector[pool_size].hash = hash;
+    pool_vector[pool_size].hash_next = pool_hash_table[hash];
+    pool_hash_table[hash] = &pool_vector[pool_size];
     pool_size++;
     return offset;
 }
 
-/* Output the literal table */
+/* Output the literal table after SCAN, and return the barrier that
+   ends it */
 
-static void
+static rtx
 dump_table(rtx scan)
 {
     int i;
@@ -224,7 +316,11 @@ dump_table(rtx scan)
 
     scan = emit_insn_after(gen_consttable_end(), scan);
     scan = emit_barrier_after(scan);
+
+    for (i = 0; i < pool_size; i++)
+        pool_hash_table[pool_vector[i].hash] = 0;
     pool_size = 0;
+    return scan;
 }
 
 /* Non zero if the src operand needs to be fixed up */
@@ -316,17 +412,69 @@ broken_move(rtx insn)
     return 0;
 }
 
-/* Recursively search through all of the blocks in a function
-   checking to see if any of the variables created in that
-   function match the RTX called 'orig'.  If they do then
-   replace them with the RTX called 'replacement'.  */
+/* The constant pool references that thumb_reorg has replaced, and
+   what replaced them.  The variables of the function that refer to
+   them are fixed up in one walk at the end, rather than a walk for
+   each.  The first of several equal references is the one used.  */
+
+typedef struct pool_symbol
+{
+    rtx orig;
+    rtx replacement;
+    struct pool_symbol *hash_next;
+} pool_symbol;
+
+static pool_symbol *pool_symbols;
+static int n_pool_symbols;
+static int max_pool_symbols;
+static pool_symbol *pool_symbol_table[POOL_HASH_SIZE];
+
+/* Record that ORIG has been replaced by REPLACEMENT. */
+
+static void
+add_pool_symbol(rtx orig, rtx replacement)
+{
+    if (n_pool_symbols == max_pool_symbols)
+    {
+        max_pool_symbols = max_pool_symbols * 2 + 16;
+        pool_symbols = (pool_symbol *)
+            xrealloc(pool_symbols, max_pool_symbols * sizeof (pool_symbol));
+    }
+
+    pool_symbols[n_pool_symbols].orig = orig;
+    pool_symbols[n_pool_symbols].replacement = replacement;
+    n_pool_symbols++;
+}
+
+/* Return what replaced the first recorded reference equal to X,
+   or zero. */
+
+static rtx
+find_pool_symbol(rtx x)
+{
+    pool_symbol *p;
+    pool_symbol *found = 0;
+
+    for (p = pool_symbol_table[pool_hash(x) % POOL_HASH_SIZE];
+         p; p = p->hash_next)
+        if ((found == 0 || p < found) && rtx_equal_p(x, p->orig))
+            found = p;
+
+    return found ? found->replacement : 0;
+}
+
+/* Recursively search through all of the blocks starting with BLOCK
+   checking to see if any of the variables created in that function
+   match one of the recorded pool references.  If they do then replace
+   them with what replaced the reference.  */
 
 static void
-replace_symbols_in_block(tree block, rtx orig, rtx replacement)
+replace_symbols_in_blocks(tree block)
 {
     for (; block; block = BLOCK_CHAIN(block))
     {
         tree sym;
+        rtx replacement;
 
         if (!TREE_USED(block))
             continue;
@@ -337,21 +485,48 @@ replace_symbols_in_block(tree block, rtx orig, rtx replacement)
                   || DECL_IGNORED_P(sym)
                   || TREE_CODE(sym) != VAR_DECL
                   || DECL_EXTERNAL(sym)
-                  || !rtx_equal_p(DECL_RTL(sym), orig)
+                  || (replacement = find_pool_symbol(DECL_RTL(sym))) == 0
                   )
                 continue;
 
             DECL_RTL(sym) = replacement;
         }
 
-        replace_symbols_in_block(BLOCK_SUBBLOCKS(block), orig, replacement);
+        replace_symbols_in_blocks(BLOCK_SUBBLOCKS(block));
     }
 }
 
+/* Replace the recorded pool references in the variables of the
+   function whose outermost block is BLOCK.  */
+
+static void
+replace_symbols_in_block(tree block)
+{
+    int i;
+    unsigned int hash;
+
+    for (i = 0; i < n_pool_symbols; i++)
+    {
+        hash = pool_hash(pool_symbols[i].orig) % POOL_HASH_SIZE;
+        pool_symbols[i].hash_next = pool_symbol_table[hash];
+        pool_symbol_table[hash] = &pool_symbols[i];
+    }
+
+    replace_symbols_in_blocks(block);
+
+    for (i = 0; i < n_pool_symbols; i++)
+        pool_symbol_table[pool_hash(pool_symbols[i].orig) % POOL_HASH_SIZE]
+            = 0;
+    n_pool_symbols = 0;
+}
+
 void
 thumb_reorg(rtx first)
 {
     rtx insn;
+
+    n_pool_symbols = 0;
+
     for (insn = first; insn; insn = NEXT_INSN(insn))
     {
         if (broken_move(insn))
@@ -360,6 +535,7 @@ thumb_reorg(rtx first)
                a barrier to stick the constant table behind */
             rtx scan;
             rtx barrier = find_barrier(insn);
+            int changed_mode = 0;
 
             /* Now find all the moves between the points and modify them */
             for (scan = insn; scan != barrier; scan = NEXT_INSN(scan))
@@ -385,6 +561,7 @@ thumb_reorg(rtx first)
                         if (GET_CODE(dst) != REG)
                             abort();
                         PUT_MODE(dst, SImode);
+                        changed_mode = 1;
                     }
 
                     offset = add_constant(src, mode);
@@ -429,17 +606,26 @@ thumb_reorg(rtx first)
                         && write_symbols != NO_DEBUG
                         && GET_CODE(src) == MEM
                         && GET_CODE(XEXP(src, 0)) == SYMBOL_REF)
-                        replace_symbols_in_block
-                            (DECL_INITIAL(current_function_decl), src, newsrc);
+                        add_pool_symbol(src, newsrc);
 
                     /* Kill old insn */
                     delete_insn(scan);
                     scan = newinsn;
                 }
             }
-            dump_table(barrier);
+            barrier = dump_table(barrier);
+
+            /* Nothing up to the end of the table can need fixing now,
+               so carry on from there.  But changing the mode of a
+               register above may have broken other moves to it, which
+               we must find just as before. */
+            if (!changed_mode)
+                insn = barrier;
         }
     }
+
+    if (n_pool_symbols > 0)
+        replace_symbols_in_block(DECL_INITIAL(current_function_decl));
 }
 
 /* Routines for generating rtl */
@@ -1415,6 +1601,181 @@ thumb_print_operand(FILE *f, rtx x, int code)
         abort();
 }
 
+/* Output a line holding the data directive DIRECTIVE for the constant X.
+   Integers, which make up most initialized data, are formatted by hand
+   and the line written in one piece.  */
+
+void
+thumb_output_data(FILE *f, const char *directive, rtx x)
+{
+    char buf[32];
+    int len;
+
+    if (GET_CODE(x) != CONST_INT)
+    {
+        fputs(directive, f);
+        output_addr_const(f, x);
+        fputc('\n', f);
+        return;
+    }
+
+    len = strlen(directive);
+    memcpy(buf, directive, len);
+    len += sprint_wint(buf + len, INTVAL(x));
+    buf[len++] = '\n';
+    fwrite(buf, 1, len, f);
+}
+
+/* Output LEN bytes of STRING as .ascii directives, starting a new line
+   once one gets long, or after a newline that is followed by printable
+   text.  The text is built up in a buffer rather than written a
+   character at a time.  */
+
+void
+thumb_output_ascii(FILE *f, const unsigned char *string, int len)
+{
+    char buf[1024];
+    int i, n, cur_pos = 17;
+
+    memcpy(buf, "\t.ascii\t\"", 9);
+    n = 9;
+
+    for (i = 0; i < len; i++)
+    {
+        int c = string[i];
+
+        switch (c)
+        {
+        case '\"':
+        case '\\':
+            buf[n++] = '\\';
+            buf[n++] = c;
+            cur_pos += 2;
+            break;
+
+        case TARGET_NEWLINE:
+            buf[n++] = '\\';
+            buf[n++] = 'n';
+            if (i + 1 < len
+                && (((c = string[i + 1]) >= '\040' && c <= '~')
+                    || c == TARGET_TAB))
+                cur_pos = 32767;        /* break right here */
+            else
+                cur_pos += 2;
+            break;
+
+        case TARGET_TAB:
+            buf[n++] = '\\';
+            buf[n++] = 't';
+            cur_pos += 2;
+            break;
+
+        case TARGET_FF:
+            buf[n++] = '\\';
+            buf[n++] = 'f';
+            cur_pos += 2;
+            break;
+
+        case TARGET_BS:
+            buf[n++] = '\\';
+            buf[n++] = 'b';
+            cur_pos += 2;
+            break;
+
+        case TARGET_CR:
+            buf[n++] = '\\';
+            buf[n++] = 'r';
+            cur_pos += 2;
+            break;
+
+        default:
+            if (c >= ' ' && c < 0177)
+            {
+                buf[n++] = c;
+                cur_pos++;
+            }
+            else
+            {
+                buf[n++] = '\\';
+                buf[n++] = '0' + ((c >> 6) & 7);
+                buf[n++] = '0' + ((c >> 3) & 7);
+                buf[n++] = '0' + (c & 7);
+                cur_pos += 4;
+            }
+        }
+
+        if (cur_pos > 72 && i + 1 < len)
+        {
+            cur_pos = 17;
+            memcpy(buf + n, "\"\n\t.ascii\t\"", 11);
+            n += 11;
+        }
+
+        /* Flush while there is still room for the longest step above.  */
+        if (n > (int) sizeof buf - 16)
+        {
+            fwrite(buf, 1, n, f);
+            n = 0;
+        }
+    }
+
+    buf[n++] = '"';
+    buf[n++] = '\n';
+    fwrite(buf, 1, n, f);
+}
+
+/* Output the N integer constants of SIZE bytes in VALUES, which
+   output_constant has collected for -fpack-data.  Up to 16 values go on
+   each line; a long run of bytes is output as .ascii text instead.  */
+
+void
+thumb_output_data_run(FILE *f, const HOST_WIDE_INT *values, int n, int size)
+{
+    const char *directive;
+    char buf[16 + 16 * (MAX_WINT_CHARS + 2)];
+    int i, j, len;
+
+    if (size == 1 && n >= 16)
+    {
+        unsigned char bytes[256];
+
+        for (i = 0; i < n && values[i] >= -128 && values[i] <= 255; i++)
+            ;
+
+        if (i == n)
+        {
+            for (i = 0; i < n; i += j)
+            {
+                for (j = 0; j < (int) sizeof bytes && i + j < n; j++)
+                    bytes[j] = values[i + j];
+                thumb_output_ascii(f, bytes, j);
+            }
+            return;
+        }
+    }
+
+    directive = (size == 4 ? "\t.word\t" : size == 2 ? "\t.short\t" : "\t.byte\t");
+
+    for (i = 0; i < n; i += 16)
+    {
+        len = strlen(directive);
+        memcpy(buf, directive, len);
+
+        for (j = i; j < n && j < i + 16; j++)
+        {
+            if (j > i)
+            {
+                buf[len++] = ',';
+                buf[len++] = ' ';
+            }
+            len += sprint_wint(buf + len, values[j]);
+        }
+
+        buf[len++] = '\n';
+        fwrite(buf, 1, len, f);
+    }
+}
+
 /* Decide whether a type should be returned in memory (true)
    or in a register (false).  This is called by the macro
    RETURN_IN_MEMORY.  */
@@ -143,26 +143,18 @@ extern int target_flags;
 #define ASM_OUTPUT_BYTE(STREAM,VALUE)					\
   fprintf ((STREAM), "\t.byte\t0x%x\n", (VALUE))
 
-#define ASM_OUTPUT_INT(STREAM,VALUE)					\
-{									\
-  fprintf (STREAM, "\t.word\t");					\
-  output_addr_const (STREAM, (VALUE));					\
-  fprintf (STREAM, "\n");						\
-}
+#define ASM_OUTPUT_INT(STREAM,VALUE)  \
+  thumb_output_data ((STREAM), "\t.word\t", (VALUE))
 
-#define ASM_OUTPUT_SHORT(STREAM,VALUE)					\
-{									\
-  fprintf (STREAM, "\t.short\t");					\
-  output_addr_const (STREAM, (VALUE));					\
-  fprintf (STREAM, "\n");						\
-}
+#define ASM_OUTPUT_SHORT(STREAM,VALUE)  \
+  thumb_output_data ((STREAM), "\t.short\t", (VALUE))
 
-#define ASM_OUTPUT_CHAR(STREAM,VALUE)					\
-{									\
-  fprintf (STREAM, "\t.byte\t");					\
-  output_addr_const (STREAM, (VALUE));					\
-  fprintf (STREAM, "\n");						\
-}
+#define ASM_OUTPUT_CHAR(STREAM,VALUE)  \
+  thumb_output_data ((STREAM), "\t.byte\t", (VALUE))
+
+/* This is how to output a run of integer constants for -fpack-data.  */
+#define ASM_OUTPUT_DATA_RUN(STREAM, VALUES, N, SIZE)  \
+  thumb_output_data_run ((STREAM), (VALUES), (N), (SIZE))
 
 #define ASM_OUTPUT_DOUBLE(STREAM, VALUE)  				\
 do { char dstr[30];							\
@@ -193,74 +185,7 @@ do { char dstr[30];							\
 
 /* This is how to output a string.  */
 #define ASM_OUTPUT_ASCII(STREAM, STRING, LEN)				\
-do {									\
-  register int i, len = (LEN), cur_pos = 17;				\
-  register unsigned char *string = (unsigned char *)(STRING);		\
-  fprintf ((STREAM), "\t.ascii\t\"");					\
-  for (i = 0; i < len; i++)						\
-    {									\
-      register int c = string[i];					\
-									\
-      switch (c)							\
-	{								\
-	case '\"':							\
-	case '\\':							\
-	  putc ('\\', (STREAM));					\
-	  putc (c, (STREAM));						\
-	  cur_pos += 2;							\
-	  break;							\
-									\
-	case TARGET_NEWLINE:						\
-	  fputs ("\\n", (STREAM));					\
-	  if (i+1 < len							\
-	      && (((c = string[i+1]) >= '\040' && c <= '~')		\
-		  || c == TARGET_TAB))					\
-	    cur_pos = 32767;		/* break right here */		\
-	  else								\
-	    cur_pos += 2;						\
-	  break;							\
-									\
-	case TARGET_TAB:						\
-	  fputs ("\\t", (STREAM));					\
-	  cur_pos += 2;							\
-	  break;							\
-									\
-	case TARGET_FF:							\
-	  fputs ("\\f", (STREAM));					\
-	  cur_pos += 2;							\
-	  break;							\
-									\
-	case TARGET_BS:							\
-	  fputs ("\\b", (STREAM));					\
-	  cur_pos += 2;							\
-	  break;							\
-									\
-	case TARGET_CR:							\
-	  fputs ("\\r", (STREAM));					\
-	  cur_pos += 2;							\
-	  break;							\
-									\
-	default:							\
-	  if (c >= ' ' && c < 0177)					\
-	    {								\
-	      putc (c, (STREAM));					\
-	      cur_pos++;						\
-	    }								\
-	  else								\
-	    {								\
-	      fprintf ((STREAM), "\\%03o", c);				\
-	      cur_pos += 4;						\
-	    }								\
-	}								\
-									\
-      if (cur_pos > 72 && i+1 < len)					\
-	{								\
-	  cur_pos = 17;							\
-	  fprintf ((STREAM), "\"\n\t.ascii\t\"");			\
-	}								\
-    }									\
-  fprintf ((STREAM), "\"\n");						\
-} while (0)
+  thumb_output_ascii ((STREAM), (const unsigned char *) (STRING), (LEN))
 
 /* Output and Generation of Labels */
 #define ASM_OUTPUT_LABEL(STREAM,NAME) \
@@ -1076,8 +1001,7 @@ int thumb_shiftable_const ();
 #define MACHINE_DEPENDENT_REORG(INSN) thumb_reorg ((INSN))
 
 #include <stdio.h>
-
-enum machine_mode;
+#include "machmode.h"
 
 struct rtx_def;
 typedef struct rtx_def *rtx;
@@ -1099,6 +1023,9 @@ extern char *thumb_unexpanded_epilogue();
 extern char *thumb_load_double_from_address();
 extern char *output_move_mem_multiple();
 extern void thumb_print_operand(FILE *, rtx, int);
+extern void thumb_output_data(FILE *, const char *, rtx);
+extern void thumb_output_ascii(FILE *, const unsigned char *, int);
+extern void thumb_output_data_run(FILE *, const HOST_WIDE_INT *, int, int);
 extern int thumb_return_in_memory(tree);
 extern void thumb_override_options();
 extern int arm_valid_machine_decl_attribute(tree, tree, tree, tree);
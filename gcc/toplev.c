@@ -114,6 +114,7 @@ static void open_dump_file (char *, char *);
 static void close_dump_file (void (*)(FILE *, rtx), rtx);
 static void dump_rtl (char *, tree, void (*)(FILE *, rtx), rtx);
 static void clean_dump_file (char *);
+static int dump_function_p (tree);
 static void compile_file (char *);
 static void display_help (void);
 
@@ -196,6 +197,24 @@ int flag_print_asm_name = 0;
 int mach_dep_reorg_dump = 0;
 enum graph_dump_types graph_dump_format;
 
+/* Every per-function dump flag above, so that dumps can be switched off
+   for functions not named by -dumpfunction.  */
+
+static int *const function_dump_flags[] =
+{
+    &rtl_dump, &jump_opt_dump, &addressof_dump, &cse_dump, &gcse_dump,
+    &loop_dump, &cse2_dump, &flow_dump, &combine_dump, &regmove_dump,
+    &local_reg_dump, &global_reg_dump, &jump2_opt_dump, &mach_dep_reorg_dump
+};
+
+#define NUM_FUNCTION_DUMP_FLAGS NUM_ELEM(function_dump_flags)
+
+/* Names given with -dumpfunction.  If there are any, the per-pass dumps
+   are written only for functions with one of these names.  */
+
+static char **dump_function_names;
+static int n_dump_function_names;
+
 /* Name for output file of assembly code, specified with -o.  */
 
 char *asm_file_name;
@@ -584,6 +603,9 @@ int flag_instrument_function_entry_exit = 0;
 /* Use hex instead of decimal in ASM output.  */
 int flag_hex_asm = 0;
 
+/* Pack runs of integer data into multi-value directives.  */
+int flag_pack_data = 0;
+
 typedef struct
 {
     char *string;
@@ -723,6 +745,8 @@ lang_independent_options f_options[] =
      "Instrument function entry/exit with profiling calls"},
     {"hex-asm", &flag_hex_asm, 1,
      "Use hex instead of decimal in assembly output"},
+    {"pack-data", &flag_pack_data, 1,
+     "Output runs of integer data with several values per directive"},
 };
 
 #define NUM_ELEM(a)  (sizeof (a) / sizeof ((a)[0]))
@@ -1890,6 +1914,26 @@ clean_dump_file(char *suffix)
     return;
 }
 
+/* Return nonzero if the dumps requested with -d should be written
+   for the function DECL.  */
+static int
+dump_function_p(tree decl)
+{
+    char *name;
+    int i;
+
+    if (n_dump_function_names == 0)
+        return 1;
+
+    name = IDENTIFIER_POINTER(DECL_NAME(decl));
+
+    for (i = 0; i < n_dump_function_names; i++)
+        if (!strcmp(name, dump_function_names[i]))
+            return 1;
+
+    return 0;
+}
+
 
 /* Compile an entire file of output from cpp, named NAME.
    Write a file of assembly output and various debugging dumps.  */
@@ -2555,6 +2599,18 @@ rest_of_compilation(tree decl)
     /* Likewise, for DECL_ARGUMENTS.  */
     tree saved_arguments = 0;
     int failure = 0;
+    /* The dump flags in effect before this function was found not to be
+       selected by -dumpfunction.  */
+    int saved_dump_flags[NUM_FUNCTION_DUMP_FLAGS];
+    int suppress_dumps = !dump_function_p(decl);
+    size_t i;
+
+    if (suppress_dumps)
+        for (i = 0; i < NUM_FUNCTION_DUMP_FLAGS; i++)
+        {
+            saved_dump_flags[i] = *function_dump_flags[i];
+            *function_dump_flags[i] = 0;
+        }
 
     /* If we are reconsidering an inline function
        at the end of compilation, skip the stuff for making it inline.  */
@@ -3269,6 +3325,10 @@ exit_rest_of_compilation:
 
     /* Reset global variables.  */
     free_basic_block_vars(0);
+
+    if (suppress_dumps)
+        for (i = 0; i < NUM_FUNCTION_DUMP_FLAGS; i++)
+            *function_dump_flags[i] = saved_dump_flags[i];
 }
 
 static void
@@ -3321,6 +3381,7 @@ display_help()
     printf("  -version                Display the compiler's version\n");
     printf("  -d[letters]             Enable dumps from specific passes of the compiler\n");
     printf("  -dumpbase <file>        Base name to be used for dumps from specific passes\n");
+    printf("  -dumpfunction <name>    Only write those dumps for the function <name>\n");
     printf("  --help                  Display this information\n");
 
     undoc = 0;
@@ -3650,6 +3711,12 @@ main(int argc, char **argv)
             {
                 dump_base_name = argv[++i];
             }
+            else if (!strcmp(str, "dumpfunction"))
+            {
+                dump_function_names = (char **) xrealloc(dump_function_names,
+                                                          (n_dump_function_names + 1) * sizeof (char *));
+                dump_function_names[n_dump_function_names++] = argv[++i];
+            }
             else if (str[0] == 'd')
             {
                 char *p = &str[1];
@@ -948,7 +948,10 @@ assemble_zeros (size)
   else
 #endif
     if (size > 0)
-      ASM_OUTPUT_SKIP (asm_out_file, size);
+      {
+	output_data_run ();
+	ASM_OUTPUT_SKIP (asm_out_file, size);
+      }
 }
 
 /* Assemble an alignment pseudo op for an ALIGN-bit boundary.  */
@@ -1342,8 +1345,11 @@ assemble_variable (decl, top_level, at_end, dont_output_data)
   if (!dont_output_data)
     {
       if (DECL_INITIAL (decl))
-	/* Output the actual data.  */
-	output_constant (DECL_INITIAL (decl), TREE_INT_CST_LOW (size_tree));
+	{
+	  /* Output the actual data.  */
+	  output_constant (DECL_INITIAL (decl), TREE_INT_CST_LOW (size_tree));
+	  output_data_run ();
+	}
       else
 	/* Leave space for it.  */
 	assemble_zeros (TREE_INT_CST_LOW (size_tree));
@@ -2819,6 +2825,7 @@ output_constant_def_contents (exp, reloc, labelno)
 		   (TREE_CODE (exp) == STRING_CST
 		    ? TREE_STRING_LENGTH (exp)
 		    : int_size_in_bytes (TREE_TYPE (exp))));
+  output_data_run ();
 
 }
 
@@ -3571,6 +3578,33 @@ output_addressed_constants (exp)
   return reloc;
 }
 
+/* With -fpack-data, output_constant collects runs of integer constants
+   of one size here, and ASM_OUTPUT_DATA_RUN writes each run out with as
+   few directives as it can.  A run is written out before anything else
+   goes to the data, and at the end of each initializer.  */
+
+#ifdef ASM_OUTPUT_DATA_RUN
+#define MAX_DATA_RUN 1024
+static HOST_WIDE_INT data_run[MAX_DATA_RUN];
+static int data_run_size;
+#endif
+static int data_run_length;
+
+/* Output the integer constants collected by output_constant, if any.  */
+
+void
+output_data_run ()
+{
+#ifdef ASM_OUTPUT_DATA_RUN
+  if (data_run_length > 0)
+    {
+      ASM_OUTPUT_DATA_RUN (asm_out_file, data_run, data_run_length,
+			   data_run_size);
+      data_run_length = 0;
+    }
+#endif
+}
+
 /* Output assembler code for constant EXP to FILE, with no label.
    This includes the pseudo-op such as ".int" or ".byte", and a newline.
    Assumes output_addressed_constants has been done on EXP already.
@@ -3616,6 +3650,41 @@ output_constant (exp, size)
       return;
     }
 
+#ifdef ASM_OUTPUT_DATA_RUN
+  /* Add a plain integer to the run being collected.  Anything else
+     except an aggregate, which is taken apart below, ends the run
+     before it is expanded, since expanding it may output constants.  */
+  if (flag_pack_data
+      && (code == INTEGER_TYPE || code == CHAR_TYPE || code == BOOLEAN_TYPE
+	  || code == ENUMERAL_TYPE || code == POINTER_TYPE)
+      && (size == 1 || size == 2 || size == 4))
+    {
+      tree value = exp;
+
+      while (TREE_CODE (value) == NOP_EXPR || TREE_CODE (value) == CONVERT_EXPR
+	     || TREE_CODE (value) == NON_LVALUE_EXPR)
+	value = TREE_OPERAND (value, 0);
+
+      if (TREE_CODE (value) == INTEGER_CST)
+	{
+	  rtx x = expand_expr (value, NULL_RTX, VOIDmode, EXPAND_INITIALIZER);
+
+	  if (GET_CODE (x) == CONST_INT)
+	    {
+	      if (data_run_length == MAX_DATA_RUN
+		  || (data_run_length > 0 && size != data_run_size))
+		output_data_run ();
+	      data_run_size = size;
+	      data_run[data_run_length++] = INTVAL (x);
+	      return;
+	    }
+	}
+    }
+#endif
+
+  if (data_run_length > 0 && TREE_CODE (exp) != CONSTRUCTOR)
+    output_data_run ();
+
   switch (code)
     {
     case CHAR_TYPE:
@@ -3862,6 +3931,9 @@ output_constructor (exp, size)
 	  if (val == 0)
 	    val = integer_zero_node;
 
+	  /* The bytes holding bit-fields are output directly.  */
+	  output_data_run ();
+
 	  /* If this field does not start in this (or, next) byte,
 	     skip some bytes.  */
 	  if (next_offset / BITS_PER_UNIT != total_bytes)